@@ -0,0 +1,105 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The CSG class
+*  The operands' spans are merged by sweeping over their
+*  boundaries in order.  A surface point does not say which
+*  operand it came from, so normal() tests each operand's
+*  normal: it belongs to the operand whose inside and outside
+*  it separates, and is the CSG normal (or its reverse) if it
+*  also separates the inside and outside of the result.
+-------------------------------------------------------------*/
+
+#include "CSG.h"
+#include <algorithm>
+#include <initializer_list>
+
+static const float EPSILON = 1e-4f;
+static const float PROBE = 1e-3f;   //Offset either side of a surface point in normal()
+
+bool CSG::combine(bool inA, bool inB) const {
+	switch (op_) {
+		case UNION:        return inA || inB;
+		case INTERSECTION: return inA && inB;
+		default:           return inA && !inB;
+	}
+}
+
+bool CSG::intervals(glm::vec3 p0, glm::vec3 dir, SpanList& spans) {
+	SpanList sa, sb;
+	if (!a_->intervals(p0, dir, sa)) sa.clear();
+	if (!b_->intervals(p0, dir, sb)) sb.clear();
+
+	//Boundary k of a list is span k/2's tIn (even k) or tOut (odd k)
+	auto boundary = [](const SpanList& s, int k) {
+		return (k & 1) ? s[k / 2].tOut : s[k / 2].tIn;
+	};
+	int ka = 0, kb = 0, na = 2 * sa.count, nb = 2 * sb.count;
+	bool inside = false;
+	float start = 0;
+	spans.clear();
+	while (ka < na || kb < nb) {
+		float t;
+		if (kb >= nb || (ka < na && boundary(sa, ka) <= boundary(sb, kb))) t = boundary(sa, ka++);
+		else t = boundary(sb, kb++);
+
+		bool now = combine(ka & 1, kb & 1);
+		if (now && !inside) start = t;
+		else if (!now && inside && t > start) spans.add(start, t);
+		inside = now;
+	}
+	return spans.count > 0;
+}
+
+/**
+* The first boundary of the combined solid in front of the ray.
+*/
+float CSG::intersect(glm::vec3 p0, glm::vec3 dir) {
+	SpanList spans;
+	if (!intervals(p0, dir, spans)) return -1.0f;
+	for (int k = 0; k < spans.count; k++) {
+		if (spans[k].tIn > EPSILON) return spans[k].tIn;
+		if (spans[k].tOut > EPSILON) return spans[k].tOut;
+	}
+	return -1.0f;
+}
+
+glm::vec3 CSG::normal(glm::vec3 p) {
+	for (SceneObject* operand : { a_.get(), b_.get() }) {
+		glm::vec3 n = operand->normal(p);
+		glm::vec3 back = p - PROBE * n, front = p + PROBE * n;
+		if (operand->contains(back) == operand->contains(front)) continue;   //Not on this operand
+
+		bool behind  = combine(a_->contains(back), b_->contains(back));
+		bool inFront = combine(a_->contains(front), b_->contains(front));
+		if (behind && !inFront) return n;
+		if (!behind && inFront) return -n;    //Inner surface, e.g. the wall of a hole
+	}
+	return a_->normal(p);
+}
+
+bool CSG::getBounds(glm::vec3& lo, glm::vec3& hi) {
+	glm::vec3 alo, ahi, blo, bhi;
+	bool boundedA = a_->getBounds(alo, ahi);
+	bool boundedB = b_->getBounds(blo, bhi);
+	switch (op_) {
+		case UNION:
+			if (!boundedA || !boundedB) return false;
+			lo = glm::min(alo, blo);
+			hi = glm::max(ahi, bhi);
+			return true;
+		case INTERSECTION:
+			if (!boundedA && !boundedB) return false;
+			lo = boundedA ? alo : blo;
+			hi = boundedA ? ahi : bhi;
+			if (boundedA && boundedB) {
+				lo = glm::max(alo, blo);
+				hi = glm::min(ahi, bhi);
+			}
+			return true;
+		default:
+			lo = alo;
+			hi = ahi;
+			return boundedA;
+	}
+}
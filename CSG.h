@@ -0,0 +1,42 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The CSG class
+*  Constructive solid geometry: the union, intersection or
+*  difference of two solids, worked out from the intervals the
+*  two operands report along each ray.  The operands must
+*  implement intervals() (Sphere, Cylinder, TruncatedCone,
+*  Instance and CSG do; see hasIntervals()) and may be shared
+*  between objects.
+-------------------------------------------------------------*/
+
+#ifndef H_CSG
+#define H_CSG
+
+#include <glm/glm.hpp>
+#include <memory>
+#include "SceneObject.h"
+
+class CSG : public SceneObject {
+public:
+	enum Op { UNION, INTERSECTION, DIFFERENCE };   //DIFFERENCE is a minus b
+
+private:
+	Op op_;
+	std::shared_ptr<SceneObject> a_;
+	std::shared_ptr<SceneObject> b_;
+
+	bool combine(bool inA, bool inB) const;
+
+public:
+	CSG(Op op, std::shared_ptr<SceneObject> a, std::shared_ptr<SceneObject> b)
+	  : op_(op), a_(a), b_(b) {}
+
+	float       intersect(glm::vec3 p0, glm::vec3 dir) override;
+	glm::vec3   normal   (glm::vec3 p)       override;
+	bool        getBounds(glm::vec3& lo, glm::vec3& hi) override;
+	bool        intervals(glm::vec3 p0, glm::vec3 dir, SpanList& spans) override;
+	bool        hasIntervals() override { return true; }
+};
+
+#endif //!H_CSG
@@ -0,0 +1,74 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Camera class
+-------------------------------------------------------------*/
+
+#include "Camera.h"
+#include <algorithm>
+#include <cmath>
+
+glm::vec3 Camera::forward() const {
+	float y = glm::radians(yaw), p = glm::radians(pitch);
+	return glm::vec3(sin(y) * cos(p), sin(p), -cos(y) * cos(p));
+}
+
+glm::vec3 Camera::right() const {
+	float y = glm::radians(yaw);
+	return glm::vec3(cos(y), 0, sin(y));
+}
+
+glm::vec3 Camera::up() const {
+	return glm::cross(right(), forward());
+}
+
+/**
+* Direction (not normalised) from the eye through the point (x, y)
+* of the image window.
+*/
+glm::vec3 Camera::primaryDir(float x, float y) const {
+	return x * right() + y * up() + edist * forward();
+}
+
+/**
+* Direction through sample (sx, sy) of the n x n grid in cell (i, j) when the
+* window is divided into div x div cells.  Every pass that generates primary
+* rays goes through here so they all get bit-identical directions.
+*/
+glm::vec3 Camera::sampleDir(int i, int j, int sx, int sy, int div, int n) const {
+	float cellX = (xmax - xmin) / div;
+	float cellY = (ymax - ymin) / div;
+	float u = (sx + 0.5f) / float(n);
+	float v = (sy + 0.5f) / float(n);
+	return primaryDir(xmin + i * cellX + u * cellX, ymin + j * cellY + v * cellY);
+}
+
+/**
+* Inverse of primaryDir: finds the window coordinates (x, y) where point p
+* appears, and its depth along the viewing direction.  Returns false if p is
+* behind the eye.
+*/
+bool Camera::project(glm::vec3 p, float& x, float& y, float& depth) const {
+	glm::vec3 v = p - eye;
+	depth = glm::dot(v, forward());
+	if (depth <= 1e-4f) return false;
+	float s = edist / depth;
+	x = glm::dot(v, right()) * s;
+	y = glm::dot(v, up()) * s;
+	return true;
+}
+
+/**
+* Moves the eye relative to the current orientation.  Forward motion stays
+* in the horizontal plane so looking down does not sink the camera.
+*/
+void Camera::move(float dRight, float dUp, float dForward) {
+	float y = glm::radians(yaw);
+	glm::vec3 flat(sin(y), 0, -cos(y));
+	eye += dRight * right() + dUp * glm::vec3(0, 1, 0) + dForward * flat;
+}
+
+void Camera::turn(float dYaw, float dPitch) {
+	yaw += dYaw;
+	pitch = std::max(-89.0f, std::min(89.0f, pitch + dPitch));
+}
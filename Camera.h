@@ -0,0 +1,38 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Camera class
+*  A pinhole camera looking through a rectangular window on an
+*  image plane EDIST in front of the eye.  With the default
+*  position and orientation it reproduces the original fixed
+*  view: eye at the origin looking down -z.
+-------------------------------------------------------------*/
+
+#ifndef H_CAMERA
+#define H_CAMERA
+
+#include <glm/glm.hpp>
+
+class Camera {
+public:
+	glm::vec3 eye = glm::vec3(0);   //Position of the eye
+	float yaw = 0;                  //Rotation about +y in degrees (positive turns right)
+	float pitch = 0;                //Rotation above the horizon in degrees
+	float edist, xmin, xmax, ymin, ymax;   //Image plane distance and window
+
+	Camera(float planeDist, float x0, float x1, float y0, float y1)
+	  : edist(planeDist), xmin(x0), xmax(x1), ymin(y0), ymax(y1) {}
+
+	glm::vec3 forward() const;
+	glm::vec3 right() const;
+	glm::vec3 up() const;
+
+	glm::vec3 primaryDir(float x, float y) const;
+	glm::vec3 sampleDir(int i, int j, int sx, int sy, int div, int n) const;
+	bool project(glm::vec3 p, float& x, float& y, float& depth) const;
+
+	void move(float dRight, float dUp, float dForward);
+	void turn(float dYaw, float dPitch);
+};
+
+#endif //!H_CAMERA
@@ -0,0 +1,105 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Tile culling
+-------------------------------------------------------------*/
+
+#include "Culling.h"
+#include <algorithm>
+#include <cmath>
+
+static const float BOX_MARGIN = 1e-3f;   //Slack on box overlap tests for rounding
+
+/**
+* Sample-space rectangle [s0, s1] x [t0, t1] covered by the object's bounding box,
+* padded by one sample.  Objects without bounds, or whose box reaches behind the
+* eye, cover the whole image.  Samples per side is 'size'; the result is clipped
+* to the incoming value of the rectangle.  Returns false if nothing is left.
+*/
+bool screenFootprint(SceneObject* obj, const Camera& cam, int size,
+                     int& s0, int& s1, int& t0, int& t1)
+{
+	glm::vec3 lo, hi;
+	if (!obj->getBounds(lo, hi)) return true;
+
+	float xlo = 1.e+30f, xhi = -1.e+30f, ylo = 1.e+30f, yhi = -1.e+30f;
+	for (int c = 0; c < 8; c++) {
+		glm::vec3 corner((c & 1) ? hi.x : lo.x, (c & 2) ? hi.y : lo.y, (c & 4) ? hi.z : lo.z);
+		float x, y, depth;
+		if (!cam.project(corner, x, y, depth)) return true;
+		xlo = std::min(xlo, x); xhi = std::max(xhi, x);
+		ylo = std::min(ylo, y); yhi = std::max(yhi, y);
+	}
+
+	float sw = (cam.xmax - cam.xmin) / size;     //Size of one sample
+	float sh = (cam.ymax - cam.ymin) / size;
+	s0 = std::max(s0, (int)std::floor((xlo - cam.xmin) / sw) - 1);
+	s1 = std::min(s1, (int)std::floor((xhi - cam.xmin) / sw) + 1);
+	t0 = std::max(t0, (int)std::floor((ylo - cam.ymin) / sh) - 1);
+	t1 = std::min(t1, (int)std::floor((yhi - cam.ymin) / sh) + 1);
+	return s0 <= s1 && t0 <= t1;
+}
+
+/**
+* Objects whose footprint overlaps cells [i0, i1) x [j0, j1) of a div x div image
+* with n x n samples per cell.
+*/
+void primaryCandidates(const Scene& scene, const Camera& cam, int div, int n,
+                       int i0, int j0, int i1, int j1, std::vector<int>& out)
+{
+	out.clear();
+	for (int k = 0; k < (int)scene.objects.size(); k++) {
+		int s0 = i0 * n, s1 = i1 * n - 1, t0 = j0 * n, t1 = j1 * n - 1;
+		if (screenFootprint(scene.objects[k], cam, div * n, s0, s1, t0, t1)) out.push_back(k);
+	}
+}
+
+/**
+* For each light, the objects whose box overlaps the box around the primary hits
+* [hitLo, hitHi] and the light.
+*/
+void shadowCandidates(const Scene& scene, glm::vec3 hitLo, glm::vec3 hitHi,
+                      std::vector<std::vector<int>>& out)
+{
+	out.assign(scene.lights.size(), std::vector<int>());
+	for (int k = 0; k < (int)scene.objects.size(); k++) {
+		glm::vec3 lo, hi;
+		bool bounded = scene.objects[k]->getBounds(lo, hi);
+		for (size_t l = 0; l < scene.lights.size(); l++) {
+			glm::vec3 blo = glm::min(hitLo, scene.lights[l]) - glm::vec3(BOX_MARGIN);
+			glm::vec3 bhi = glm::max(hitHi, scene.lights[l]) + glm::vec3(BOX_MARGIN);
+			if (!bounded || (lo.x <= bhi.x && hi.x >= blo.x && lo.y <= bhi.y && hi.y >= blo.y
+			                 && lo.z <= bhi.z && hi.z >= blo.z))
+				out[l].push_back(k);
+		}
+	}
+}
+
+void CullStats::add(const TileCandidates& c) {
+	tiles++;
+	primary += c.primary.size();
+	primaryMax = std::max(primaryMax, (int)c.primary.size());
+	for (const std::vector<int>& list : c.shadow) {
+		shadow += list.size();
+		shadowLists++;
+		shadowMax = std::max(shadowMax, (int)list.size());
+	}
+}
+
+void CullStats::merge(const CullStats& s) {
+	objects = std::max(objects, s.objects);
+	tiles += s.tiles;
+	primary += s.primary;
+	primaryMax = std::max(primaryMax, s.primaryMax);
+	shadow += s.shadow;
+	shadowLists += s.shadowLists;
+	shadowMax = std::max(shadowMax, s.shadowMax);
+}
+
+float CullStats::meanPrimary() const {
+	return tiles ? float(primary) / tiles : 0.0f;
+}
+
+float CullStats::meanShadow() const {
+	return shadowLists ? float(shadow) / shadowLists : 0.0f;
+}
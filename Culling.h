@@ -0,0 +1,54 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Tile culling
+*  Per-tile candidate lists: before a tile is traced, the objects
+*  its rays can possibly hit are found from their bounding boxes.
+*  Primary rays test only objects whose projected box overlaps
+*  the tile.  Shadow rays from the tile's primary hits to a light
+*  stay inside the box around those hits and the light, so they
+*  test only objects whose box overlaps it.  Objects without
+*  bounds are always candidates.
+-------------------------------------------------------------*/
+
+#ifndef H_CULLING
+#define H_CULLING
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "Scene.h"
+#include "Camera.h"
+
+struct TileCandidates {
+	std::vector<int> primary;               //Objects primary rays of the tile may hit, in scene order
+	std::vector<std::vector<int>> shadow;   //Per light: objects that may shadow the tile's primary hits
+};
+
+/**
+* Lengths of the candidate lists built so far, summed over tiles.
+*/
+struct CullStats {
+	int objects = 0;                 //Objects in the scene
+	int tiles = 0;
+	long long primary = 0;
+	int primaryMax = 0;
+	long long shadow = 0;            //Summed over lights as well
+	int shadowLists = 0;
+	int shadowMax = 0;
+
+	void add(const TileCandidates& c);
+	void merge(const CullStats& s);
+	float meanPrimary() const;
+	float meanShadow() const;
+};
+
+bool screenFootprint(SceneObject* obj, const Camera& cam, int size,
+                     int& s0, int& s1, int& t0, int& t1);
+
+void primaryCandidates(const Scene& scene, const Camera& cam, int div, int n,
+                       int i0, int j0, int i1, int j1, std::vector<int>& out);
+
+void shadowCandidates(const Scene& scene, glm::vec3 hitLo, glm::vec3 hitHi,
+                      std::vector<std::vector<int>>& out);
+
+#endif //!H_CULLING
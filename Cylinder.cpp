@@ -59,3 +59,47 @@ glm::vec3 Cylinder::normal(glm::vec3 p) {
     glm::vec3 n(lp.x, 0, lp.z);
     return glm::normalize(n);
 }
+
+// Range of t where the line is between the cap planes y = -halfH and y = halfH
+static bool slab(float y0, float dy, float halfH, float& tIn, float& tOut) {
+    if (std::fabs(dy) <= EPSILON) {
+        tIn = -1.e+30f;
+        tOut = 1.e+30f;
+        return std::fabs(y0) <= halfH;
+    }
+    float ta = (-halfH - y0) / dy;
+    float tb = ( halfH - y0) / dy;
+    tIn  = std::min(ta, tb);
+    tOut = std::max(ta, tb);
+    return true;
+}
+
+bool Cylinder::intervals(glm::vec3 p0, glm::vec3 dir, SpanList& spans) {
+    glm::vec3 ro = p0 - center;
+    float tIn, tOut;
+    if (!slab(ro.y, dir.y, height * 0.5f, tIn, tOut)) return false;
+
+    float A = dir.x*dir.x + dir.z*dir.z;
+    float B = 2.0f * (ro.x*dir.x + ro.z*dir.z);
+    float C = ro.x*ro.x + ro.z*ro.z - radius*radius;
+    if (A > EPSILON) {
+        float disc = B*B - 4.0f*A*C;
+        if (disc <= 0.0f) return false;
+        float sq = std::sqrt(disc);
+        tIn  = std::max(tIn,  (-B - sq) / (2.0f*A));
+        tOut = std::min(tOut, (-B + sq) / (2.0f*A));
+    }
+    else if (C > 0.0f) return false;   //Parallel to the axis, outside the side
+
+    if (tIn >= tOut) return false;
+    spans.clear();
+    spans.add(tIn, tOut);
+    return true;
+}
+
+bool Cylinder::getBounds(glm::vec3& lo, glm::vec3& hi) {
+    glm::vec3 ext(radius, height * 0.5f, radius);
+    lo = center - ext;
+    hi = center + ext;
+    return true;
+}
@@ -0,0 +1,195 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Denoiser class
+*  The colour is divided by the albedo before filtering so that
+*  texture detail is not blurred, filtered with a 5x5 B3-spline
+*  kernel whose taps are spread further apart every pass, and
+*  multiplied back by the albedo at the end.  Each pass splits
+*  the image into bands of rows that run as tasks on the pool.
+*  The filter works on one plane per channel and adds one tap
+*  to a whole row at a time, so its inner loop vectorizes.
+-------------------------------------------------------------*/
+
+#include "Denoiser.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+
+static const float KERNEL[5] = { 1.0f/16, 1.0f/4, 3.0f/8, 1.0f/4, 1.0f/16 };
+static const float ALBEDO_EPS = 1e-3f;
+static const int BAND = 16;   //Rows per pool task
+
+void GBuffer::resize(int w, int h) {
+	width = w;
+	height = h;
+	color.assign(w * h, glm::vec3(0));
+	features.assign(w * h, PixelFeatures());
+}
+
+void Denoiser::setIterations(int iterations) {
+	iterations_ = iterations;
+}
+
+/**
+* Working memory apply() allocates for an image of the given size.
+*/
+size_t Denoiser::scratchBytes(int width, int height) {
+	return size_t(width) * height * sizeof(float) * 10;   //Guide 4, two Planes of 3
+}
+
+/**
+* Filters the colour buffer in place.  The passes run one after another, each
+* as bands of rows on the pool at the given priority; the calling thread waits.
+*/
+void Denoiser::apply(GBuffer& buf, ThreadPool& pool, int priority) {
+	int npix = buf.width * buf.height;
+	if (npix == 0) return;
+
+	//Demodulate: filter irradiance rather than final colour
+	Guide guide;
+	guide.width = buf.width;
+	guide.height = buf.height;
+	Planes cur, next;
+	for (int c = 0; c < 3; c++) {
+		guide.normal[c].resize(npix);
+		cur.color[c].resize(npix);
+		next.color[c].resize(npix);
+	}
+	guide.depth.resize(npix);
+	for (int i = 0; i < npix; i++) {
+		const PixelFeatures& f = buf.features[i];
+		glm::vec3 a = glm::max(f.albedo, glm::vec3(ALBEDO_EPS));
+		for (int c = 0; c < 3; c++) {
+			cur.color[c][i] = buf.color[i][c] / a[c];
+			guide.normal[c][i] = f.normal[c];
+		}
+		guide.depth[i] = f.depth;
+	}
+
+	std::mutex mutex;
+	std::condition_variable finished;
+	float sigmaColor = sigmaColor_;
+	for (int pass = 0; pass < iterations_; pass++) {
+		int step = 1 << pass;
+		int left = (buf.height + BAND - 1) / BAND;
+		for (int y0 = 0; y0 < buf.height; y0 += BAND) {
+			int y1 = std::min(y0 + BAND, buf.height);
+			pool.submit(priority, [&, y0, y1, step, sigmaColor] {
+				filterRows(y0, y1, step, sigmaColor, guide, cur, next);
+				std::lock_guard<std::mutex> lock(mutex);
+				if (--left == 0) finished.notify_all();
+			});
+		}
+		std::unique_lock<std::mutex> lock(mutex);
+		finished.wait(lock, [&] { return left == 0; });
+		lock.unlock();
+		std::swap(cur, next);
+		sigmaColor *= 0.5f;
+	}
+
+	for (int i = 0; i < npix; i++) {
+		glm::vec3 a = glm::max(buf.features[i].albedo, glm::vec3(ALBEDO_EPS));
+		glm::vec3 c(cur.color[0][i], cur.color[1][i], cur.color[2][i]);
+		buf.color[i] = glm::clamp(c * a, glm::vec3(0.0f), glm::vec3(1.0f));
+	}
+}
+
+/**
+* A run of pixels in every plane: the centre pixels of a row, or the taps they read.
+*/
+struct Run {
+	const float* color[3];
+	const float* normal[3];
+	const float* depth;
+};
+
+/**
+* Adds one tap, of kernel weight k, to n centre pixels.  With S = 1 the taps are
+* n consecutive pixels; with S = 0 they are all the same edge pixel.  The
+* accumulators hold the weighted colour sums and the weight sum per pixel; they
+* are marked __restrict so the compiler need not check them against the planes.
+*/
+template <int S>
+static void addTap(int n, float k, const Run& p, const Run& q, float invColor, float invNormal,
+                   float invDepth, float* __restrict sum0, float* __restrict sum1,
+                   float* __restrict sum2, float* __restrict wsum)
+{
+	for (int x = 0; x < n; x++) {
+		int t = x * S;
+		float q0 = q.color[0][t], q1 = q.color[1][t], q2 = q.color[2][t];
+		float d0 = q0 - p.color[0][x], d1 = q1 - p.color[1][x], d2 = q2 - p.color[2][x];
+		float n0 = q.normal[0][t] - p.normal[0][x];
+		float n1 = q.normal[1][t] - p.normal[1][x];
+		float n2 = q.normal[2][t] - p.normal[2][x];
+		float dz = std::fabs(q.depth[t] - p.depth[x]);
+		float e = (d0*d0 + d1*d1 + d2*d2) * invColor + (n0*n0 + n1*n1 + n2*n2) * invNormal + dz * invDepth;
+		float wq = k * fastExpNeg(e);
+		sum0[x] += wq * q0;
+		sum1[x] += wq * q1;
+		sum2[x] += wq * q2;
+		wsum[x] += wq;
+	}
+}
+
+static Run runAt(const float* const color[3], const std::vector<float> (&normal)[3],
+                 const std::vector<float>& depth, int p)
+{
+	return Run{ { color[0] + p, color[1] + p, color[2] + p },
+	            { normal[0].data() + p, normal[1].data() + p, normal[2].data() + p },
+	            depth.data() + p };
+}
+
+/**
+* One a-trous pass over rows [y0, y1).  Each tap is weighted by the B3-spline
+* kernel and by how similar its colour, normal and depth are to the centre pixel.
+* Taps past the image edge read the edge pixel.
+*/
+void Denoiser::filterRows(int y0, int y1, int step, float sigmaColor,
+                          const Guide& guide, const Planes& in, Planes& out)
+{
+	const int w = guide.width, h = guide.height;
+	const float invColor = 1.0f / (sigmaColor * sigmaColor);
+	const float invNormal = 1.0f / (sigmaNormal_ * sigmaNormal_);
+	const float invDepth = 1.0f / (sigmaDepth_ * step);
+	const float* color[3] = { in.color[0].data(), in.color[1].data(), in.color[2].data() };
+
+	std::vector<float> sum0(w), sum1(w), sum2(w), wsum(w);
+	for (int y = y0; y < y1; y++) {
+		std::fill(sum0.begin(), sum0.end(), 0.0f);
+		std::fill(sum1.begin(), sum1.end(), 0.0f);
+		std::fill(sum2.begin(), sum2.end(), 0.0f);
+		std::fill(wsum.begin(), wsum.end(), 0.0f);
+
+		for (int ky = 0; ky < 5; ky++) {
+			int qy = std::min(std::max(y + (ky - 2) * step, 0), h - 1);
+			for (int kx = 0; kx < 5; kx++) {
+				int dx = (kx - 2) * step;
+				int xlo = std::min(std::max(-dx, 0), w);      //Taps in [xlo, xhi) are inside
+				int xhi = std::max(std::min(w - dx, w), xlo);
+				float k = KERNEL[kx] * KERNEL[ky];
+				auto add = [&](int x0, int x1, int q, bool edge) {
+					if (x1 <= x0) return;
+					Run p = runAt(color, guide.normal, guide.depth, y * w + x0);
+					Run t = runAt(color, guide.normal, guide.depth, qy * w + q);
+					if (edge) addTap<0>(x1 - x0, k, p, t, invColor, invNormal, invDepth,
+					                    &sum0[x0], &sum1[x0], &sum2[x0], &wsum[x0]);
+					else addTap<1>(x1 - x0, k, p, t, invColor, invNormal, invDepth,
+					               &sum0[x0], &sum1[x0], &sum2[x0], &wsum[x0]);
+				};
+				add(0, xlo, 0, true);
+				add(xlo, xhi, xlo + dx, false);
+				add(xhi, w, w - 1, true);
+			}
+		}
+
+		for (int x = 0; x < w; x++) {
+			int p = y * w + x;
+			out.color[0][p] = sum0[x] / wsum[x];
+			out.color[1][p] = sum1[x] / wsum[x];
+			out.color[2][p] = sum2[x] / wsum[x];
+		}
+	}
+}
@@ -0,0 +1,69 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Denoiser class
+*  Edge-aware a-trous wavelet filter (Dammertz et al. 2010) that
+*  smooths a low sample-count image while keeping edges, using
+*  the normal, depth and albedo of the primary hit at each pixel.
+*  It hides aliasing but does not recover what supersampling
+*  does: on room.scene, 1 sample per pixel denoised is no closer
+*  to a 64-sample reference (RMSE 8.4 levels) than undenoised,
+*  where 4 samples reach 3.2.  It is a look for previews, off
+*  by default, not a cheaper route to a final image.
+-------------------------------------------------------------*/
+
+#ifndef H_DENOISER
+#define H_DENOISER
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "ThreadPool.h"
+
+/**
+* Per-pixel data written by the tracer: the traced colour plus the
+* features of the first surface hit, which guide the filter.
+*/
+struct PixelFeatures {
+	glm::vec3 normal = glm::vec3(0);   //Unit normal at the primary hit (zero if the ray missed)
+	glm::vec3 albedo = glm::vec3(0);   //Material colour at the primary hit
+	float depth = 0;                   //Distance from the eye to the primary hit
+	glm::vec3 position = glm::vec3(0); //World position of the primary hit
+	int object = -1;                   //Index of the object hit (-1 if the ray missed)
+};
+
+struct GBuffer {
+	int width = 0;
+	int height = 0;
+	std::vector<glm::vec3> color;
+	std::vector<PixelFeatures> features;
+
+	void resize(int w, int h);
+};
+
+class Denoiser {
+private:
+	//Each channel in a plane of its own, so the filter loops run over contiguous floats
+	struct Planes {
+		std::vector<float> color[3];   //Colour divided by albedo
+	};
+	struct Guide {
+		int width = 0, height = 0;
+		std::vector<float> normal[3];
+		std::vector<float> depth;
+	};
+
+	int   iterations_ = 5;        //Filter passes; pass k uses a tap spacing of 2^k
+	float sigmaColor_ = 0.6f;     //Colour edge-stopping width (halved every pass)
+	float sigmaNormal_ = 0.3f;    //Normal edge-stopping width
+	float sigmaDepth_ = 0.5f;     //Depth edge-stopping width, per unit of tap spacing
+
+	void filterRows(int y0, int y1, int step, float sigmaColor,
+	                const Guide& guide, const Planes& in, Planes& out);
+
+public:
+	void apply(GBuffer& buf, ThreadPool& pool, int priority = 0);
+	static size_t scratchBytes(int width, int height);
+	void setIterations(int iterations);
+};
+
+#endif //!H_DENOISER
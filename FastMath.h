@@ -0,0 +1,155 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Fast math
+*  Approximations of the functions used in shading, for the
+*  fast-math render mode and the denoiser.  Each has a stated
+*  error bound and no library calls or data-dependent branches
+*  besides the range folding, so loops over them can be
+*  vectorized.
+*  floorInt() is exact; the others are approximate:
+*      fastAtan2       |error| < 2e-5 rad
+*      fastAsin        |error| < 7e-5 rad
+*      fastNormalize   relative length error < 5e-6
+*      fastExpNeg      relative error < 1e-5
+*      PowTable        |error| < 1e-4 for x in [0, 1] (clamped to it), exponent >= 1
+-------------------------------------------------------------*/
+
+#ifndef H_FAST_MATH
+#define H_FAST_MATH
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+inline int floorInt(float x) {
+	int i = (int)x;
+	return i - (x < (float)i);
+}
+
+/**
+* atan on [-1, 1] by a minimax polynomial, folded to the full circle.
+*/
+inline float fastAtan2(float y, float x) {
+	const float PI = 3.14159265f;
+	float ax = std::fabs(x), ay = std::fabs(y);
+	float big = ax > ay ? ax : ay, small = ax > ay ? ay : ax;
+	float a = (big > 0.0f) ? small / big : 0.0f;
+	float s = a * a;
+	float r = a * (0.9998660f + s * (-0.3302995f + s * (0.1801410f + s * (-0.0851330f + s * 0.0208351f))));
+	if (ay > ax) r = 0.5f * PI - r;
+	if (x < 0.0f) r = PI - r;
+	return (y < 0.0f) ? -r : r;
+}
+
+/**
+* Abramowitz and Stegun 4.4.45, extended to negative x by symmetry.
+*/
+inline float fastAsin(float x) {
+	const float HALF_PI = 1.57079633f;
+	float a = std::fabs(x);
+	if (a > 1.0f) a = 1.0f;
+	float r = HALF_PI - std::sqrt(1.0f - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f - a * 0.0187293f)));
+	return (x < 0.0f) ? -r : r;
+}
+
+/**
+* Reciprocal square root from the bit-level initial guess and two Newton steps.
+*/
+inline float fastRsqrt(float x) {
+	uint32_t i;
+	memcpy(&i, &x, 4);
+	i = 0x5f375a86u - (i >> 1);
+	float y;
+	memcpy(&y, &i, 4);
+	y = y * (1.5f - 0.5f * x * y * y);
+	return y * (1.5f - 0.5f * x * y * y);
+}
+
+inline glm::vec3 fastNormalize(glm::vec3 v) {
+	return v * fastRsqrt(glm::dot(v, v));
+}
+
+/**
+* exp(-x) for x >= 0, as 2^(-x log2 e): the integer part goes into the float's
+* exponent and a minimax polynomial gives 2^f on [0, 1).  x is capped at 80 on
+* its bits, which order like the values for x >= 0; GCC turns a select there
+* into a branch, which stops loops over this function vectorizing.
+*/
+inline float fastExpNeg(float x) {
+	const uint32_t CAP = 0x42A00000u;   //80.0f
+	uint32_t bits;
+	memcpy(&bits, &x, 4);
+	int32_t over = (int32_t)(bits - CAP);
+	bits = CAP + (uint32_t)(over & (over >> 31));
+	memcpy(&x, &bits, 4);
+
+	float t = -1.44269504f * x;
+	int i = floorInt(t);
+	float f = t - (float)i;
+	float p = 1.0f + f * (0.69304401f + f * (0.24128269f + f * (0.05224090f + f * 0.01342655f)));
+	bits = (uint32_t)(i + 127) << 23;
+	float scale;
+	memcpy(&scale, &bits, 4);
+	return p * scale;
+}
+
+/**
+* pow(x, exponent) for x in [0, 1] by linear interpolation in a table.  The
+* table is sized for an interpolation error of 5e-5, leaving the rest of the
+* 1e-4 bound to float rounding.  Only exponents from 1 up are tabulated: below
+* 1 the curve is steepest at 0 and the error there falls off too slowly with
+* the spacing.  Exponents that would need more than MAX_ENTRIES entries
+* (above about 82) are not tabulated either; see fits().
+*/
+class PowTable {
+private:
+	float exponent_;
+	std::vector<float> values_;
+	float scale_;                  //Entries per unit of x
+
+	//With spacing h the error is at most h^2 / 8 max|f''|, and f'' = s(s - 1)x^(s - 2)
+	//peaks at x = 1 for s >= 2.  For 1 < s < 2 it peaks at x = h over all but the
+	//first interval, whose chord errs by h^s max(t - t^s); both go as h^s.  The
+	//line s = 1 is exact.
+	static double entries(float exponent) {
+		const double TOLERANCE = 5e-5;
+		double s = exponent, n = 0.0;
+		if (s >= 2.0) n = std::sqrt(s * (s - 1.0) / (8.0 * TOLERANCE));
+		else if (s > 1.0) {
+			double t = std::pow(s, -1.0 / (s - 1.0));    //Where t - t^s peaks
+			double c = std::max(t - std::pow(t, s), s * (s - 1.0) / 8.0);
+			n = std::pow(c / TOLERANCE, 1.0 / s);
+		}
+		return std::max(std::ceil(n), 256.0);
+	}
+
+public:
+	static const int MAX_ENTRIES = 4096;
+
+	static bool fits(float exponent) {
+		return exponent >= 1.0f && entries(exponent) <= MAX_ENTRIES;
+	}
+
+	explicit PowTable(float exponent) : exponent_(exponent) {
+		int n = (int)std::min(entries(exponent), double(MAX_ENTRIES));
+		values_.resize(n + 2);
+		for (int k = 0; k <= n + 1; k++) values_[k] = std::pow(std::fmin(float(k) / n, 1.0f), exponent);
+		scale_ = float(n);
+	}
+
+	float operator()(float x) const {
+		float u = std::fmin(std::fmax(x, 0.0f), 1.0f) * scale_;
+		int k = (int)u;
+		return values_[k] + (u - k) * (values_[k + 1] - values_[k]);
+	}
+
+	float getExponent() const {
+		return exponent_;
+	}
+};
+
+#endif //!H_FAST_MATH
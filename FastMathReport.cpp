@@ -0,0 +1,76 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Fast-math accuracy report
+*  Renders a scene with precise and with fast-math shading and
+*  reports the time of each and how far the fast image is from
+*  the precise one, along with the measured error of each
+*  approximation in FastMath.h.
+*
+*  Usage:  FastMathReport.out [scene file]     (default room.scene)
+-------------------------------------------------------------*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "SceneParser.h"
+#include "RenderJob.h"
+#include "ImageIO.h"
+#include "FastMath.h"
+
+static GBuffer renderTimed(ThreadPool& pool, std::shared_ptr<const Scene> scene,
+                           const RenderSettings& settings, double& ms)
+{
+	auto start = std::chrono::steady_clock::now();
+	std::shared_ptr<RenderJob> job = RenderJob::start(pool, scene, settings);
+	job->wait();
+	ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return job->snapshot();
+}
+
+//Largest error of each approximation over random arguments
+static void functionErrors() {
+	std::mt19937 rng(363);
+	std::uniform_real_distribution<float> U(-1.0f, 1.0f);
+	double atanErr = 0, asinErr = 0, normErr = 0, powErr = 0;
+	PowTable table(50.0f);
+	for (int k = 0; k < 1000000; k++) {
+		float x = U(rng), y = U(rng), z = U(rng);
+		atanErr = std::max(atanErr, std::fabs(fastAtan2(y, x) - std::atan2(double(y), double(x))));
+		asinErr = std::max(asinErr, std::fabs(fastAsin(x) - std::asin(double(x))));
+		normErr = std::max(normErr, std::fabs(double(glm::length(fastNormalize(glm::vec3(x, y, z) * 100.0f))) - 1.0));
+		float a = std::fabs(x);
+		powErr = std::max(powErr, std::fabs(table(a) - std::pow(double(a), 50.0)));
+	}
+	printf("Function errors:  atan2 %.2e  asin %.2e  normalize %.2e  pow(x, 50) %.2e\n",
+	       atanErr, asinErr, normErr, powErr);
+}
+
+int main(int argc, char *argv[]) {
+	const char* path = (argc > 1) ? argv[1] : "room.scene";
+	std::shared_ptr<Scene> scene = std::make_shared<Scene>();
+	RenderSettings settings;
+	bool denoise = false;
+	std::string error;
+	if (!loadSceneFile(path, *scene, settings, denoise, error)) {
+		fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+
+	ThreadPool pool;
+	double preciseMs, fastMs;
+	settings.fastMath = false;
+	GBuffer precise = renderTimed(pool, scene, settings, preciseMs);
+	settings.fastMath = true;
+	GBuffer fast = renderTimed(pool, scene, settings, fastMs);
+
+	ImageDiff d = compareImages(precise, fast);
+	printf("Scene %s, %dx%d, %dx%d samples per pixel\n", path, settings.div, settings.div,
+	       settings.grid, settings.grid);
+	printf("Render time:      precise %.1f ms  fast %.1f ms  (%.2fx)\n", preciseMs, fastMs, preciseMs / fastMs);
+	printf("Image error:      max %.5f  mean %.2e  PSNR %.1f dB  pixels off by > 1/255: %d of %d\n",
+	       d.maxError, d.meanError, d.psnr, d.pixelsOver, d.pixels);
+	functionErrors();
+	return 0;
+}
@@ -0,0 +1,99 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The FrameGovernor class
+*  Frame cost is modelled as (cost per sample) x div^2 x grid^2.
+*  The per-sample cost is measured every frame and smoothed, and
+*  the next frame's resolution and sample count are chosen to fit
+*  the target.  Resolution is traded first, samples second.
+-------------------------------------------------------------*/
+
+#include "FrameGovernor.h"
+#include <algorithm>
+#include <cmath>
+
+FrameGovernor::FrameGovernor(float targetMs, int minDiv, int maxDiv, int maxGrid)
+	: targetMs_(targetMs), minDiv_(minDiv), maxDiv_(maxDiv), maxGrid_(maxGrid),
+	  div_(minDiv), grid_(1) {}
+
+/**
+* Chooses the settings for the frame about to be rendered and starts timing it.
+* A moving view gets the budgeted settings; a still view gets one refinement
+* step, unless 'hold' asks to keep the previous frame's settings.
+*/
+void FrameGovernor::beginFrame(bool hold) {
+	if (moving_) fitBudget();
+	else if (!hold) stepUp();
+	start_ = std::chrono::steady_clock::now();
+}
+
+/**
+* Measures the frame just rendered, in which 'samples' primary samples were
+* traced, and updates the per-sample cost estimate.  The caller passes the
+* samples it actually traced: fewer than div^2 x grid^2 when AA is off, the
+* denoiser is on or pixels were reused from the previous frame.
+*/
+void FrameGovernor::endFrame(float samples) {
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start_;
+	if (samples > 0) {
+		float cost = elapsed.count() / samples;
+		sampleCost_ = (sampleCost_ > 0) ? 0.7f * sampleCost_ + 0.3f * cost : cost;
+	}
+	moving_ = false;
+}
+
+/**
+* Chooses the largest resolution (and then AA grid) whose predicted
+* cost fits inside the target frame time.
+*/
+void FrameGovernor::fitBudget() {
+	if (sampleCost_ <= 0) return;
+	float budget = targetMs_ / sampleCost_;   //Number of primary samples we can afford
+
+	int div = (int)std::sqrt(budget);
+	div_ = std::max(minDiv_, std::min(div, maxDiv_));
+
+	int grid = (int)std::sqrt(budget / (float(div_) * div_));
+	grid_ = std::max(1, std::min(grid, maxGrid_));
+}
+
+/**
+* Doubles the resolution until it reaches full size, then adds AA samples.
+*/
+void FrameGovernor::stepUp() {
+	if (div_ < maxDiv_) div_ = std::min(div_ * 2, maxDiv_);
+	else if (grid_ < maxGrid_) grid_++;
+}
+
+/**
+* Called whenever the image has to be redrawn from scratch, e.g. the window
+* was resized or the camera moved.  The next frame is rendered on budget.
+*/
+void FrameGovernor::viewChanged() {
+	moving_ = true;
+}
+
+void FrameGovernor::setTarget(float targetMs) {
+	targetMs_ = targetMs;
+	moving_ = true;
+}
+
+int FrameGovernor::getNumDiv() {
+	return div_;
+}
+
+int FrameGovernor::getGrid() {
+	return grid_;
+}
+
+float FrameGovernor::getTarget() {
+	return targetMs_;
+}
+
+/**
+* Returns true when the view is still and the last frame was rendered at
+* full resolution with the full AA grid.
+*/
+bool FrameGovernor::isConverged() {
+	return !moving_ && div_ == maxDiv_ && grid_ == maxGrid_;
+}
@@ -0,0 +1,47 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The FrameGovernor class
+*  Picks the internal resolution (number of cells per side) and
+*  the anti-aliasing grid for each frame so that the measured
+*  frame time stays close to a target while the view is changing,
+*  and steps back up to full quality once the view is still.
+*  A caller still refining a frame can hold the settings, so
+*  the step up waits until that frame is finished.
+-------------------------------------------------------------*/
+
+#ifndef H_FRAME_GOVERNOR
+#define H_FRAME_GOVERNOR
+
+#include <chrono>
+
+class FrameGovernor {
+private:
+	float targetMs_;        //Frame time to aim for while the view is changing
+	int   minDiv_;          //Lowest resolution the governor may drop to
+	int   maxDiv_;          //Full-quality resolution
+	int   maxGrid_;         //Full-quality AA grid (maxGrid_ x maxGrid_ samples)
+	int   div_;             //Resolution for the next frame
+	int   grid_;            //AA grid for the next frame
+	float sampleCost_ = 0;  //Smoothed cost of one primary sample (ms)
+	bool  moving_ = true;   //True until a frame completes without a view change
+	std::chrono::steady_clock::time_point start_;
+
+	void fitBudget();
+	void stepUp();
+
+public:
+	FrameGovernor(float targetMs, int minDiv, int maxDiv, int maxGrid);
+
+	void beginFrame(bool hold = false);
+	void endFrame(float samples);
+	void viewChanged();
+	void setTarget(float targetMs);
+
+	int   getNumDiv();
+	int   getGrid();
+	float getTarget();
+	bool  isConverged();
+};
+
+#endif //!H_FRAME_GOVERNOR
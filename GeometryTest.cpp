@@ -0,0 +1,133 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Geometry test
+*  Checks the span lists CSG::intervals() builds for union,
+*  intersection and difference along a ray, that Transform's
+*  inverse undoes it and composes in the stated order, and that
+*  Instance maps normals with the inverse transpose, so a
+*  non-uniformly scaled sphere has the normals of its
+*  ellipsoid.  Exits with 1 on the first failure.
+-------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include "CSG.h"
+#include "Instance.h"
+#include "Sphere.h"
+#include "Transform.h"
+
+static const float TOL = 1e-4f;
+
+static void check(bool ok, const char* what) {
+	printf("%s  %s\n", ok ? "ok  " : "FAIL", what);
+	if (!ok) exit(1);
+}
+
+static bool near(float a, float b, float tol = TOL) {
+	return std::fabs(a - b) <= tol;
+}
+
+static bool near(glm::vec3 a, glm::vec3 b, float tol = TOL) {
+	return near(a.x, b.x, tol) && near(a.y, b.y, tol) && near(a.z, b.z, tol);
+}
+
+//True if 'spans' holds exactly the n spans [t[2k], t[2k + 1]]
+static bool spansAre(const SpanList& spans, const float* t, int n) {
+	if (spans.count != n) return false;
+	for (int k = 0; k < n; k++)
+		if (!near(spans[k].tIn, t[2 * k], 1e-3f) || !near(spans[k].tOut, t[2 * k + 1], 1e-3f)) return false;
+	return true;
+}
+
+static void checkCSG() {
+	//Along the x axis from x = -10: a spans t in [8, 12], b spans [9, 13]
+	auto a = std::make_shared<Sphere>(glm::vec3(0, 0, 0), 2.0f);
+	auto b = std::make_shared<Sphere>(glm::vec3(1, 0, 0), 2.0f);
+	glm::vec3 p0(-10, 0, 0), dir(1, 0, 0);
+	SpanList spans;
+
+	const float both[] = { 8, 13 };
+	check(CSG(CSG::UNION, a, b).intervals(p0, dir, spans) && spansAre(spans, both, 1),
+	      "the union of overlapping spheres is one span");
+	const float common[] = { 9, 12 };
+	check(CSG(CSG::INTERSECTION, a, b).intervals(p0, dir, spans) && spansAre(spans, common, 1),
+	      "their intersection is the overlap");
+	const float front[] = { 8, 9 };
+	check(CSG(CSG::DIFFERENCE, a, b).intervals(p0, dir, spans) && spansAre(spans, front, 1),
+	      "a - b keeps the part of a in front of b");
+
+	//A hole through the middle splits a sphere into two spans, and nesting keeps them
+	auto big = std::make_shared<Sphere>(glm::vec3(0, 0, 0), 3.0f);
+	auto core = std::make_shared<Sphere>(glm::vec3(0, 0, 0), 1.0f);
+	auto shell = std::make_shared<CSG>(CSG::DIFFERENCE, big, core);
+	const float halves[] = { 7, 9, 11, 13 };
+	check(shell->intervals(p0, dir, spans) && spansAre(spans, halves, 2),
+	      "a sphere minus its core is two spans");
+	auto far = std::make_shared<Sphere>(glm::vec3(8, 0, 0), 1.0f);
+	const float three[] = { 7, 9, 11, 13, 17, 19 };
+	check(CSG(CSG::UNION, shell, far).intervals(p0, dir, spans) && spansAre(spans, three, 3),
+	      "a nested union adds a disjoint span");
+
+	check(!CSG(CSG::INTERSECTION, core, far).intervals(p0, dir, spans) && spans.count == 0,
+	      "disjoint operands have no intersection");
+	check(!CSG(CSG::UNION, a, b).intervals(glm::vec3(-10, 5, 0), dir, spans),
+	      "a ray that misses both operands has no spans");
+	check(near(CSG(CSG::DIFFERENCE, b, a).intersect(p0, dir), 12.0f, 1e-3f),
+	      "intersect() is the first boundary of the combined solid");
+}
+
+static void checkTransform() {
+	Transform t = Transform::translate(glm::vec3(1, 2, 3)) * Transform::rotateY(30)
+	            * Transform::scale(glm::vec3(2, 1, 0.5f));
+	Transform inv = t.inverse();
+	const glm::vec3 points[] = { glm::vec3(0), glm::vec3(1, -2, 5), glm::vec3(-3, 0.5f, 7) };
+	bool undone = true, composed = true;
+	for (glm::vec3 p : points) {
+		undone = undone && near(inv.applyPoint(t.applyPoint(p)), p) && near(t.applyPoint(inv.applyPoint(p)), p);
+		glm::vec3 stepwise = Transform::translate(glm::vec3(1, 2, 3)).applyPoint(
+			Transform::rotateY(30).applyPoint(Transform::scale(glm::vec3(2, 1, 0.5f)).applyPoint(p)));
+		composed = composed && near(t.applyPoint(p), stepwise);
+	}
+	check(undone, "inverse() undoes a transform from either side");
+	check(composed, "a * b applies b first");
+	check(near(Transform::rotateZ(90).applyVector(glm::vec3(1, 0, 0)), glm::vec3(0, 1, 0)),
+	      "rotateZ(90) turns x into y");
+	check(near((t * inv).applyPoint(glm::vec3(4, 5, 6)), glm::vec3(4, 5, 6)),
+	      "a transform times its inverse is the identity");
+}
+
+static void checkInstanceNormals() {
+	//The unit sphere stretched by 2 along x: the ellipsoid x^2/4 + y^2 + z^2 = 1,
+	//whose normal at p is along the gradient (x/4, y, z)
+	auto unit = std::make_shared<Sphere>(glm::vec3(0), 1.0f);
+	Transform stretch = Transform::translate(glm::vec3(0, 0, -20)) * Transform::scale(glm::vec3(2, 1, 1));
+	Instance ellipsoid(unit, stretch);
+	bool ok = true;
+	for (float deg = 10; deg < 360; deg += 40) {
+		float a = glm::radians(deg);
+		glm::vec3 local(2 * std::cos(a), std::sin(a), 0);
+		glm::vec3 expected = glm::normalize(glm::vec3(local.x / 4, local.y, local.z));
+		glm::vec3 n = ellipsoid.normal(local + glm::vec3(0, 0, -20));
+		glm::vec3 tangent(-2 * std::sin(a), std::cos(a), 0);
+		ok = ok && near(n, expected) && near(glm::dot(n, tangent), 0.0f);
+	}
+	check(ok, "instance normals use the inverse transpose");
+	check(near(ellipsoid.intersect(glm::vec3(-10, 0, -20), glm::vec3(1, 0, 0)), 8.0f, 1e-3f),
+	      "rays hit the transformed surface");
+
+	Transform turn = Transform::translate(glm::vec3(5, 0, 0)) * Transform::rotateX(90);
+	Instance turned(unit, turn);
+	check(near(turned.normal(glm::vec3(5, 0, 1)), glm::vec3(0, 0, 1)),
+	      "normals of a rotated instance turn with it");
+}
+
+int main() {
+	checkCSG();
+	checkTransform();
+	checkInstanceNormals();
+	printf("All geometry checks passed\n");
+	return 0;
+}
@@ -0,0 +1,268 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Golden-image check
+*  Renders a set of reference scenes headlessly and compares
+*  each with a stored golden image and render time, so that an
+*  optimisation that changes the picture (ray offsets,
+*  intersection epsilons, marcher tolerances) or slows the
+*  render is caught.  The references are generated scenes
+*  covering every object kind and material, a CSG scene, a
+*  scene with a light between objects (only objects between a
+*  point and the light shade it), and any scene files given.
+*
+*  Record goldens with a build known to be good, then check:
+*      GoldenCheck.out update golden room.scene
+*      GoldenCheck.out check golden room.scene
+*  An image fails if its PSNR against the golden drops below
+*  -p dB or more than -x percent of its pixels are off by more
+*  than 2/255; the new image is then written beside the golden
+*  as name.new.ppm.  A render fails if its best time of -n runs
+*  is more than -T percent over the baseline (-T 0: ignore
+*  times).  Times only compare on the machine that recorded
+*  them.  Exits with 1 if anything failed.
+*
+*  goldens/ holds the built-in references at 128 x 128, checked
+*  by ctest with times ignored; after a change that is meant to
+*  alter the pictures, record them again with
+*      GoldenCheck.out update goldens -s 128
+*
+*  Usage:  GoldenCheck.out check|update dir [scene files] [-s size]
+*                          [-n runs] [-p minPSNR] [-x maxPercent] [-T percent]
+-------------------------------------------------------------*/
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include "SceneGenerator.h"
+#include "SceneParser.h"
+#include "ImageIO.h"
+
+struct Reference {
+	std::string name;
+	std::string text;       //Scene description, or empty to read 'path'
+	std::string path;
+};
+
+struct CheckOptions {
+	int   div = 200;
+	int   runs = 3;
+	float minPsnr = 45.0f;
+	float maxPercentOver = 0.1f;
+	float timePercent = 10.0f;
+};
+
+static const char* CSG_SCENE =
+	"light 10 15 5\n"
+	"light -10 10 0\n"
+	"sphere -6 2 -40 3\n"    "cylinder -6 2 -40 1.5 8\n"  "subtract\n"   "color 1 0.3 0.2\n"
+	"sphere 0 2 -40 3\n"     "cylinder 0 2 -40 2.2 4\n"   "intersect\n"  "color 0.2 0.8 0.3\n"
+	"sphere 6 2 -40 2.5\n"   "cone 6 -1 -40 2 0.2 5\n"    "union\n"      "color 0.3 0.4 1\n"
+	"sphere 0 -5 -35 2.5\n"  "sphere 1.2 -5 -34 2\n"      "subtract\n"   "color 0.1 0.1 0.1\n"
+	"refract 0.9 1.5\n"
+	"quad -30 -9 0  30 -9 0  30 -9 -100  -30 -9 -100\n"
+	"color 0.8 0.8 0.8\n"    "specular 0\n"               "checker\n"
+	"camera 0 0 0 0 -5\n";
+
+//A light between the floor and a sphere above it, and between two spheres side
+//by side: shadow rays must stop at the light, or both would be wrongly darkened.
+//Culling is off, as the tiles' candidate lists would drop the far objects anyway.
+static const char* SHADOW_SCENE =
+	"light 0 -3 -40\n"
+	"light -15 20 -10\n"
+	"sphere 0 6 -40 3\n"     "color 0.9 0.2 0.2\n"
+	"sphere -8 -3 -40 2.5\n" "color 0.2 0.4 0.9\n"
+	"sphere 8 -3 -40 2.5\n"  "color 0.2 0.8 0.3\n"
+	"quad -30 -9 0  30 -9 0  30 -9 -100  -30 -9 -100\n"
+	"color 0.8 0.8 0.8\n"    "specular 0\n"
+	"camera 0 0 0 0 -5\n"    "culling 0\n";
+
+static std::vector<Reference> builtinReferences() {
+	std::vector<Reference> refs;
+	GeneratorSettings gen;
+	gen.objects = 64;
+	refs.push_back({ "mixed", generateScene(gen), "" });
+
+	gen = GeneratorSettings();
+	gen.objects = 27;
+	gen.grid = true;
+	gen.seed = 2;
+	refs.push_back({ "grid", generateScene(gen), "" });
+
+	gen = GeneratorSettings();
+	gen.objects = 24;
+	gen.depth = 8;
+	gen.reflective = 0.2f;
+	gen.refractive = 0.4f;
+	gen.transparent = 0.3f;
+	gen.seed = 3;
+	refs.push_back({ "glass", generateScene(gen), "" });
+
+	gen = GeneratorSettings();
+	gen.objects = 32;
+	gen.lights = 8;
+	gen.seed = 4;
+	refs.push_back({ "lights", generateScene(gen), "" });
+
+	refs.push_back({ "csg", CSG_SCENE, "" });
+	refs.push_back({ "shadow", SHADOW_SCENE, "" });
+	return refs;
+}
+
+//Renders 'ref' opt.runs times; returns false if its description is bad
+static bool render(const Reference& ref, const CheckOptions& opt, ThreadPool& pool,
+                   GBuffer& image, double& bestMs)
+{
+	std::shared_ptr<Scene> scene = std::make_shared<Scene>();
+	RenderSettings settings;
+	bool denoise = false;
+	std::string error;
+	bool ok = ref.text.empty() ? loadSceneFile(ref.path.c_str(), *scene, settings, denoise, error)
+	                           : parseDescription(ref.text, scene.get(), &settings, &denoise, error);
+	if (!ok) {
+		fprintf(stderr, "%s: %s\n", ref.name.c_str(), error.c_str());
+		return false;
+	}
+	settings.div = opt.div;
+
+	bestMs = 1e30;
+	for (int r = 0; r < opt.runs; r++) {
+		auto start = std::chrono::steady_clock::now();
+		std::shared_ptr<RenderJob> job = RenderJob::start(pool, scene, settings);
+		job->wait();
+		bestMs = std::min(bestMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		if (r == opt.runs - 1) image = job->snapshot();
+	}
+	return true;
+}
+
+//Rounds colours as writePPM does, so an unchanged render matches its golden exactly
+static void quantize(GBuffer& image) {
+	for (glm::vec3& c : image.color)
+		c = glm::floor(glm::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f) / 255.0f;
+}
+
+static std::map<std::string, double> readBaseline(const std::string& path) {
+	std::map<std::string, double> times;
+	std::ifstream file(path);
+	std::string line, name;
+	double ms;
+	while (std::getline(file, line)) {
+		std::istringstream ls(line);
+		if (line[0] != '#' && ls >> name >> ms) times[name] = ms;
+	}
+	return times;
+}
+
+int main(int argc, char *argv[]) {
+	if (argc < 3 || (strcmp(argv[1], "check") != 0 && strcmp(argv[1], "update") != 0)) {
+		fprintf(stderr, "Usage: %s check|update dir [scene files] [-s size] [-n runs]"
+		                " [-p minPSNR] [-x maxPercent] [-T percent]\n", argv[0]);
+		return 1;
+	}
+	bool update = strcmp(argv[1], "update") == 0;
+	std::string dir = argv[2];
+	CheckOptions opt;
+	std::vector<Reference> refs = builtinReferences();
+	for (int a = 3; a < argc; a++) {
+		if (argv[a][0] != '-') {
+			std::string name = argv[a];
+			name = name.substr(name.find_last_of('/') + 1);
+			refs.push_back({ name.substr(0, name.find('.')), "", argv[a] });
+			continue;
+		}
+		if (a + 1 >= argc) {
+			fprintf(stderr, "Missing value for %s\n", argv[a]);
+			return 1;
+		}
+		float value = (float)atof(argv[++a]);
+		if      (strcmp(argv[a - 1], "-s") == 0) opt.div = (int)value;
+		else if (strcmp(argv[a - 1], "-n") == 0) opt.runs = std::max((int)value, 1);
+		else if (strcmp(argv[a - 1], "-p") == 0) opt.minPsnr = value;
+		else if (strcmp(argv[a - 1], "-x") == 0) opt.maxPercentOver = value;
+		else if (strcmp(argv[a - 1], "-T") == 0) opt.timePercent = value;
+		else {
+			fprintf(stderr, "Unknown option %s\n", argv[a - 1]);
+			return 1;
+		}
+	}
+
+	std::string baselinePath = dir + "/baseline.txt";
+	std::map<std::string, double> baseline;
+	if (update) mkdir(dir.c_str(), 0777);
+	else baseline = readBaseline(baselinePath);
+
+	ThreadPool pool;
+	std::ostringstream newBaseline;
+	newBaseline << "# Best render time in ms of each reference scene at " << opt.div << "x" << opt.div << "\n";
+	int failures = 0;
+	for (const Reference& ref : refs) {
+		GBuffer image;
+		double ms;
+		if (!render(ref, opt, pool, image, ms)) {
+			failures++;
+			continue;
+		}
+		std::string golden = dir + "/" + ref.name + ".ppm";
+		if (update) {
+			if (!writePPM(golden.c_str(), image)) {
+				fprintf(stderr, "Cannot write %s\n", golden.c_str());
+				return 1;
+			}
+			newBaseline << ref.name << " " << ms << "\n";
+			printf("%-10s recorded, %.1f ms\n", ref.name.c_str(), ms);
+			continue;
+		}
+
+		GBuffer expected;
+		bool imageOk = false;
+		char imageNote[128];
+		if (!readPPM(golden.c_str(), expected))
+			snprintf(imageNote, sizeof(imageNote), "no golden image");
+		else if (expected.width != image.width || expected.height != image.height)
+			snprintf(imageNote, sizeof(imageNote), "golden is %dx%d", expected.width, expected.height);
+		else {
+			quantize(image);
+			ImageDiff d = compareImages(expected, image, 2.0f / 255.0f);
+			imageOk = d.psnr >= opt.minPsnr && 100.0f * d.pixelsOver <= opt.maxPercentOver * d.pixels;
+			snprintf(imageNote, sizeof(imageNote), "PSNR %5.1f dB, %d px off by > 2/255", d.psnr, d.pixelsOver);
+		}
+		std::string newImage = dir + "/" + ref.name + ".new.ppm";
+		if (!imageOk) writePPM(newImage.c_str(), image);
+		else std::remove(newImage.c_str());
+
+		bool timeOk = true;
+		char timeNote[128];
+		auto base = baseline.find(ref.name);
+		if (base == baseline.end()) {
+			timeOk = opt.timePercent <= 0;
+			snprintf(timeNote, sizeof(timeNote), "%.1f ms, no baseline", ms);
+		}
+		else {
+			float change = float(100.0 * (ms / base->second - 1.0));
+			timeOk = opt.timePercent <= 0 || change <= opt.timePercent;
+			snprintf(timeNote, sizeof(timeNote), "%.1f ms vs %.1f ms (%+.1f%%)", ms, base->second, change);
+		}
+
+		printf("%-10s image %-4s %-36s  time %-4s %s\n", ref.name.c_str(), imageOk ? "ok" : "FAIL", imageNote,
+		       timeOk ? "ok" : "FAIL", timeNote);
+		if (!imageOk || !timeOk) failures++;
+	}
+
+	if (update) {
+		std::ofstream file(baselinePath);
+		file << newBaseline.str();
+		if (!file) {
+			fprintf(stderr, "Cannot write %s\n", baselinePath.c_str());
+			return 1;
+		}
+	}
+	else printf("%d of %zu reference scenes failed\n", failures, refs.size());
+	return failures ? 1 : 0;
+}
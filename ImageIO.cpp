@@ -0,0 +1,131 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Image input and output
+-------------------------------------------------------------*/
+
+#include "ImageIO.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+static const int MAX_READ_SIDE = 16384;         //Largest width or height readPPM() accepts
+static const int MAX_READ_PIXELS = 4096 * 4096; //and largest pixel count
+
+ImageDiff compareImages(const GBuffer& a, const GBuffer& b, float threshold) {
+	ImageDiff d;
+	d.pixels = a.width * a.height;
+	double sum = 0, sumSq = 0;
+	for (int p = 0; p < d.pixels; p++) {
+		glm::vec3 e = glm::abs(a.color[p] - b.color[p]);
+		float m = std::max(e.r, std::max(e.g, e.b));
+		d.maxError = std::max(d.maxError, m);
+		if (m > threshold) d.pixelsOver++;
+		sum += e.r + e.g + e.b;
+		sumSq += e.r * e.r + e.g * e.g + e.b * e.b;
+	}
+	if (d.pixels > 0) {
+		d.meanError = float(sum / (3.0 * d.pixels));
+		double mse = sumSq / (3.0 * d.pixels);
+		d.psnr = (mse > 0) ? float(10.0 * std::log10(1.0 / mse)) : INFINITY;
+	}
+	return d;
+}
+
+static unsigned char toByte(float c) {
+	return (unsigned char)(std::min(std::max(c, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+/**
+* Header of a binary PPM; 'comment', if given, is stored as a '#' line.
+*/
+std::string ppmHeader(int width, int height, const std::string& comment) {
+	std::string out = "P6\n";
+	if (!comment.empty()) out += "# " + comment + "\n";
+	return out + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+}
+
+/**
+* Converts 'count' colours to PPM bytes, three per colour.
+*/
+void encodeRGB(const glm::vec3* color, int count, unsigned char* out) {
+	for (int p = 0; p < count; p++) {
+		*out++ = toByte(color[p].r);
+		*out++ = toByte(color[p].g);
+		*out++ = toByte(color[p].b);
+	}
+}
+
+/**
+* Returns the image as a binary PPM.
+*/
+std::string encodePPM(const GBuffer& image, const std::string& comment) {
+	std::string out = ppmHeader(image.width, image.height, comment);
+	size_t header = out.size();
+	out.resize(header + 3 * size_t(image.width) * image.height);
+	unsigned char* px = (unsigned char*)&out[header];
+	for (int j = image.height - 1; j >= 0; j--, px += 3 * image.width)
+		encodeRGB(&image.color[j * image.width], image.width, px);
+	return out;
+}
+
+bool writePPM(const char* path, const GBuffer& image) {
+	std::ofstream file(path, std::ios::binary);
+	std::string data = encodePPM(image);
+	file.write(data.data(), data.size());
+	return bool(file);
+}
+
+/**
+* Reads a binary PPM with 8-bit channels into image's colours; the features
+* keep their defaults.  Returns false if the file is missing or not such a PPM,
+* or if the image is larger than MAX_READ_SIDE or MAX_READ_PIXELS allow.
+*/
+bool readPPM(const char* path, GBuffer& image) {
+	std::ifstream file(path, std::ios::binary);
+	std::string magic;
+	int size[3];
+	file >> magic;
+	if (magic != "P6") return false;
+	for (int k = 0; k < 3; k++) {
+		while (file >> std::ws && file.peek() == '#') file.ignore(1 << 16, '\n');
+		if (!(file >> size[k]) || size[k] <= 0) return false;
+	}
+	if (size[2] != 255) return false;
+	if (size[0] > MAX_READ_SIDE || size[1] > MAX_READ_SIDE || size[0] > MAX_READ_PIXELS / size[1])
+		return false;
+	file.get();   //The single whitespace before the data
+
+	int width = size[0], height = size[1];
+	std::vector<unsigned char> row(3 * size_t(width));
+	image.resize(width, height);
+	for (int j = height - 1; j >= 0; j--) {
+		if (!file.read((char*)row.data(), row.size())) return false;
+		for (int i = 0; i < width; i++) {
+			const unsigned char* px = &row[3 * i];
+			image.color[j * width + i] = glm::vec3(px[0], px[1], px[2]) / 255.0f;
+		}
+	}
+	return true;
+}
+
+/**
+* Writes a greyscale PFM.  The negative scale in the header marks the data
+* as little-endian, so values are byte-swapped on big-endian machines.
+*/
+bool writePFM(const char* path, int width, int height, const float* data) {
+	std::ofstream file(path, std::ios::binary);
+	file << "Pf\n" << width << " " << height << "\n-1.0\n";
+
+	const uint16_t probe = 1;
+	bool little = *(const unsigned char*)&probe == 1;
+	for (size_t p = 0; p < size_t(width) * height; p++) {
+		unsigned char b[4];
+		memcpy(b, &data[p], 4);
+		if (!little) { std::swap(b[0], b[3]); std::swap(b[1], b[2]); }
+		file.write((const char*)b, 4);
+	}
+	return bool(file);
+}
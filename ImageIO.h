@@ -0,0 +1,43 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Image input and output
+*  Encodes rendered images as binary PPM (P6), reads them back
+*  and writes single-channel float images as PFM.  Row 0 of a
+*  GBuffer is the bottom of the image: PPM rows are written in
+*  reverse, PFM rows in order (PFM stores the bottom row first).
+*  compareImages() measures how far one render is from another.
+-------------------------------------------------------------*/
+
+#ifndef H_IMAGE_IO
+#define H_IMAGE_IO
+
+#include <string>
+#include "Denoiser.h"
+
+/**
+* Colour differences between two images of the same size, per channel.
+*/
+struct ImageDiff {
+	float maxError = 0;
+	float meanError = 0;
+	float psnr = 0;              //dB; infinite for identical images
+	int   pixelsOver = 0;        //Pixels with a channel off by more than the threshold
+	int   pixels = 0;
+};
+
+ImageDiff compareImages(const GBuffer& a, const GBuffer& b, float threshold = 1.0f / 255.0f);
+
+std::string ppmHeader(int width, int height, const std::string& comment = "");
+
+void encodeRGB(const glm::vec3* color, int count, unsigned char* out);
+
+std::string encodePPM(const GBuffer& image, const std::string& comment = "");
+
+bool writePPM(const char* path, const GBuffer& image);
+
+bool readPPM(const char* path, GBuffer& image);
+
+bool writePFM(const char* path, int width, int height, const float* data);
+
+#endif //!H_IMAGE_IO
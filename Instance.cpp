@@ -0,0 +1,65 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Instance class
+*  Rays are taken into object space for intersection.  The
+*  object-space direction is renormalised because the primitives
+*  assume unit directions, and the resulting distance is scaled
+*  back to world units.
+-------------------------------------------------------------*/
+
+#include "Instance.h"
+#include <algorithm>
+
+Instance::Instance(std::shared_ptr<SceneObject> geometry, const Transform& toWorld)
+	: geometry_(geometry), toWorld_(toWorld)
+{
+	toLocal_ = toWorld.inverse();
+	normalMat_ = glm::transpose(toLocal_.linear);
+}
+
+float Instance::intersect(glm::vec3 p0, glm::vec3 dir) {
+	glm::vec3 lp = toLocal_.applyPoint(p0);
+	glm::vec3 ld = toLocal_.applyVector(dir);
+	float len = glm::length(ld);
+	float t = geometry_->intersect(lp, ld / len);
+	return (t > 0) ? t / len : -1.0f;
+}
+
+bool Instance::intervals(glm::vec3 p0, glm::vec3 dir, SpanList& spans) {
+	glm::vec3 lp = toLocal_.applyPoint(p0);
+	glm::vec3 ld = toLocal_.applyVector(dir);
+	float len = glm::length(ld);
+	if (!geometry_->intervals(lp, ld / len, spans)) return false;
+	for (int k = 0; k < spans.count; k++) {
+		spans[k].tIn /= len;
+		spans[k].tOut /= len;
+	}
+	return true;
+}
+
+glm::vec3 Instance::normal(glm::vec3 p) {
+	glm::vec3 n = geometry_->normal(toLocal_.applyPoint(p));
+	return glm::normalize(normalMat_ * n);
+}
+
+/**
+* World-space box around the transformed corners of the geometry's box.
+*/
+bool Instance::getBounds(glm::vec3& lo, glm::vec3& hi) {
+	glm::vec3 glo, ghi;
+	if (!geometry_->getBounds(glo, ghi)) return false;
+	lo = glm::vec3(1.e+30f);
+	hi = glm::vec3(-1.e+30f);
+	for (int c = 0; c < 8; c++) {
+		glm::vec3 corner((c & 1) ? ghi.x : glo.x, (c & 2) ? ghi.y : glo.y, (c & 4) ? ghi.z : glo.z);
+		glm::vec3 w = toWorld_.applyPoint(corner);
+		lo = glm::min(lo, w);
+		hi = glm::max(hi, w);
+	}
+	return true;
+}
+
+const Transform& Instance::getTransform() {
+	return toWorld_;
+}
@@ -0,0 +1,39 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Instance class
+*  Places a shared piece of geometry in the scene through an
+*  affine transform.  Many instances can reference the same
+*  geometry object; each instance only stores its transform and
+*  its own material (the geometry's material is ignored).
+*  The geometry may itself be an Instance.
+-------------------------------------------------------------*/
+
+#ifndef H_INSTANCE
+#define H_INSTANCE
+
+#include <glm/glm.hpp>
+#include <memory>
+#include "SceneObject.h"
+#include "Transform.h"
+
+class Instance : public SceneObject {
+private:
+	std::shared_ptr<SceneObject> geometry_;
+	Transform toWorld_;
+	Transform toLocal_;
+	glm::mat3 normalMat_;   //Inverse transpose of the linear part
+
+public:
+	Instance(std::shared_ptr<SceneObject> geometry, const Transform& toWorld);
+
+	float       intersect(glm::vec3 p0, glm::vec3 dir) override;
+	glm::vec3   normal   (glm::vec3 p)       override;
+	bool        getBounds(glm::vec3& lo, glm::vec3& hi) override;
+	bool        intervals(glm::vec3 p0, glm::vec3 dir, SpanList& spans) override;
+	bool        hasIntervals() override { return geometry_->hasIntervals(); }
+
+	const Transform& getTransform();
+};
+
+#endif //!H_INSTANCE
@@ -0,0 +1,68 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Per-pixel cost
+-------------------------------------------------------------*/
+
+#include "PixelCost.h"
+#include "ImageIO.h"
+#include <algorithm>
+#include <iostream>
+
+thread_local RayCounters* rayCounters = nullptr;
+
+void CostBuffer::resize(int w, int h) {
+	width = w;
+	height = h;
+	time.assign(w * h, 0.0f);
+	rays.assign(w * h, 0.0f);
+	tests.assign(w * h, 0.0f);
+	steps.assign(w * h, 0.0f);
+	depth.assign(w * h, 0.0f);
+}
+
+//Black - blue - red - yellow - white ramp for t in [0, 1]
+static glm::vec3 heatColor(float t) {
+	static const glm::vec3 ramp[] = { glm::vec3(0, 0, 0), glm::vec3(0, 0, 1), glm::vec3(1, 0, 0),
+	                                  glm::vec3(1, 1, 0), glm::vec3(1, 1, 1) };
+	float x = std::min(std::max(t, 0.0f), 1.0f) * 4.0f;
+	int k = std::min(int(x), 3);
+	float f = x - k;
+	return (1.0f - f) * ramp[k] + f * ramp[k + 1];
+}
+
+/**
+* Maps 'values' onto the heat ramp.  The scale ends at the 99th percentile so a
+* few extreme pixels do not wash out the rest of the map.
+*/
+static GBuffer heatmap(int width, int height, const std::vector<float>& values) {
+	std::vector<float> sorted(values);
+	size_t k = sorted.size() * 99 / 100;
+	std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+	float top = (k < sorted.size() && sorted[k] > 0) ? sorted[k] : 1.0f;
+
+	GBuffer image;
+	image.resize(width, height);
+	for (size_t p = 0; p < values.size(); p++)
+		image.color[p] = heatColor(values[p] / top);
+	return image;
+}
+
+/**
+* Writes <prefix>-time, -rays, -tests, -steps and -depth, each as a .ppm heatmap and a
+* .pfm holding the raw values.
+*/
+bool writeCostMaps(const std::string& prefix, const CostBuffer& cost) {
+	const std::pair<const char*, const std::vector<float>*> maps[] = {
+		{ "time", &cost.time }, { "rays", &cost.rays }, { "tests", &cost.tests },
+		{ "steps", &cost.steps }, { "depth", &cost.depth } };
+
+	bool ok = true;
+	for (auto& m : maps) {
+		std::string name = prefix + "-" + m.first;
+		ok &= writePPM((name + ".ppm").c_str(), heatmap(cost.width, cost.height, *m.second));
+		ok &= writePFM((name + ".pfm").c_str(), cost.width, cost.height, m.second->data());
+	}
+	if (!ok) std::cerr << "Could not write cost maps " << prefix << "-*" << std::endl;
+	return ok;
+}
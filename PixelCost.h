@@ -0,0 +1,48 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Per-pixel cost
+*  Diagnostic counters showing where in the image render time
+*  goes.  While a thread's rayCounters points at a RayCounters,
+*  every ray it casts, the intersection tests the ray makes, the
+*  sphere-tracing steps SDF objects take for it and the recursion
+*  depth it reaches are counted there; normal renders leave it
+*  null, so the counters cost one test of a thread-local
+*  pointer.  profileRegion() (Renderer.h) fills a CostBuffer,
+*  which writeCostMaps() saves as false-colour PPM heatmaps and
+*  raw PFM float images.
+-------------------------------------------------------------*/
+
+#ifndef H_PIXEL_COST
+#define H_PIXEL_COST
+
+#include <string>
+#include <vector>
+
+struct RayCounters {
+	unsigned rays = 0;      //Rays cast, including shadow rays
+	unsigned tests = 0;     //Ray-object intersection tests
+	unsigned steps = 0;     //Sphere-tracing steps in SDF objects
+	unsigned depth = 0;     //Deepest recursion step reached
+};
+
+extern thread_local RayCounters* rayCounters;
+
+/**
+* Cost of each cell, in the same layout as a GBuffer (row 0 at the bottom).
+*/
+struct CostBuffer {
+	int width = 0;
+	int height = 0;
+	std::vector<float> time;     //Wall-clock nanoseconds
+	std::vector<float> rays;
+	std::vector<float> tests;
+	std::vector<float> steps;
+	std::vector<float> depth;
+
+	void resize(int w, int h);
+};
+
+bool writeCostMaps(const std::string& prefix, const CostBuffer& cost);
+
+#endif //!H_PIXEL_COST
@@ -63,6 +63,16 @@ bool Plane::isInside(glm::vec3 q) {
 }
 
 
+bool Plane::getBounds(glm::vec3& lo, glm::vec3& hi) {
+	lo = glm::min(glm::min(a_, b_), c_);
+	hi = glm::max(glm::max(a_, b_), c_);
+	if (nverts_ == 4) {
+		lo = glm::min(lo, d_);
+		hi = glm::max(hi, d_);
+	}
+	return true;
+}
+
 //Getter function for number of vertices
 int  Plane::getNumVerts() {
 	return nverts_;
@@ -39,6 +39,8 @@ public:
 	
 	glm::vec3 normal(glm::vec3 pt);
 
+	bool getBounds(glm::vec3& lo, glm::vec3& hi);
+
 };
 
 #endif //!H_PLANE
@@ -0,0 +1,29 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Primitive
+-------------------------------------------------------------*/
+
+#include "Primitive.h"
+#include <typeinfo>
+
+/**
+* Wraps an object in the variant alternative for its exact type.  Only exact
+* matches are specialised: a subclass of Sphere, say, may override intersect()
+* and must keep virtual dispatch.
+*/
+Primitive makePrimitive(SceneObject* obj) {
+	if (typeid(*obj) == typeid(Sphere))        return static_cast<Sphere*>(obj);
+	if (typeid(*obj) == typeid(Plane))         return static_cast<Plane*>(obj);
+	if (typeid(*obj) == typeid(Cylinder))      return static_cast<Cylinder*>(obj);
+	if (typeid(*obj) == typeid(TruncatedCone)) return static_cast<TruncatedCone*>(obj);
+	if (typeid(*obj) == typeid(Torus))         return static_cast<Torus*>(obj);
+	return obj;
+}
+
+std::vector<Primitive> makePrimitives(std::vector<SceneObject*>& sceneObjects) {
+	std::vector<Primitive> prims;
+	prims.reserve(sceneObjects.size());
+	for (SceneObject* obj : sceneObjects) prims.push_back(makePrimitive(obj));
+	return prims;
+}
@@ -0,0 +1,55 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Primitive
+*  A closed set of the concrete object types held in a
+*  std::variant, so hot loops can call intersect() and normal()
+*  without going through the virtual table.  Types outside the
+*  set (e.g. Instance, generic SDF objects) fall back to the
+*  SceneObject* alternative and are dispatched virtually.
+-------------------------------------------------------------*/
+
+#ifndef H_PRIMITIVE
+#define H_PRIMITIVE
+
+#include <glm/glm.hpp>
+#include <type_traits>
+#include <variant>
+#include <vector>
+#include "SceneObject.h"
+#include "Sphere.h"
+#include "Plane.h"
+#include "Cylinder.h"
+#include "TruncatedCone.h"
+#include "Torus.h"
+
+typedef std::variant<Sphere*, Plane*, Cylinder*, TruncatedCone*, Torus*, SceneObject*> Primitive;
+
+Primitive makePrimitive(SceneObject* obj);
+std::vector<Primitive> makePrimitives(std::vector<SceneObject*>& sceneObjects);
+
+/**
+* Non-virtual calls for the concrete types (the qualified name bypasses the
+* virtual table and lets the compiler inline), virtual calls for the fallback.
+*/
+template <class T>
+inline float intersectStatic(T* obj, glm::vec3 p0, glm::vec3 dir) {
+	if constexpr (std::is_same<T, SceneObject>::value) return obj->intersect(p0, dir);
+	else return obj->T::intersect(p0, dir);
+}
+
+template <class T>
+inline glm::vec3 normalStatic(T* obj, glm::vec3 p) {
+	if constexpr (std::is_same<T, SceneObject>::value) return obj->normal(p);
+	else return obj->T::normal(p);
+}
+
+inline float intersect(const Primitive& prim, glm::vec3 p0, glm::vec3 dir) {
+	return std::visit([&](auto* obj) { return intersectStatic(obj, p0, dir); }, prim);
+}
+
+inline glm::vec3 normal(const Primitive& prim, glm::vec3 p) {
+	return std::visit([&](auto* obj) { return normalStatic(obj, p); }, prim);
+}
+
+#endif //!H_PRIMITIVE
@@ -3,27 +3,49 @@
 // The ray class (implementation)
 //==================================================
 #include "Ray.h"
+#include "PixelCost.h"
 
-//Finds the closest point of intersection of the current ray with scene objects
-void Ray::closestPt(std::vector<SceneObject*> &sceneObjects)
+//Finds the closest point of intersection of the current ray with the scene's primitives
+void Ray::closestPt(const std::vector<Primitive>& primitives)
 {
-	glm::vec3 point(0,0,0);
 	float tmin = 1.e+6;
-	for(int i = 0;  i < sceneObjects.size();  i++)
+	if(rayCounters)  //Profiling
 	{
-		float t = sceneObjects[i]->intersect(p0, dir);
-		if(t > 0)        //Intersects the object
+		rayCounters->rays++;
+		rayCounters->tests += primitives.size();
+	}
+	for(size_t i = 0;  i < primitives.size();  i++)
+	{
+		float t = intersect(primitives[i], p0, dir);
+		if(t > 0 && t < tmin)
 		{
-			point = p0 + dir*t;
-			if(t < tmin)
-			{
-				hit = point;
-				index = i;
-				dist = t;
-				tmin = t;
-			}
+			hit = p0 + dir*t;
+			index = i;
+			dist = t;
+			tmin = t;
 		}
 	}
+}
 
+//Same as above, testing only the listed primitives (indices in ascending order)
+void Ray::closestPt(const std::vector<Primitive>& primitives, const std::vector<int>& candidates)
+{
+	float tmin = 1.e+6;
+	if(rayCounters)  //Profiling
+	{
+		rayCounters->rays++;
+		rayCounters->tests += candidates.size();
+	}
+	for(int i : candidates)
+	{
+		float t = intersect(primitives[i], p0, dir);
+		if(t > 0 && t < tmin)
+		{
+			hit = p0 + dir*t;
+			index = i;
+			dist = t;
+			tmin = t;
+		}
+	}
 }
 
@@ -8,6 +8,7 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include "SceneObject.h"
+#include "Primitive.h"
 
 class Ray
 {
@@ -30,7 +31,9 @@ public:
 		p0 = p0 + RSTEP * dir;   //Ray stepping
 	}
 
-	void closestPt(std::vector<SceneObject*>& sceneObjects);
+	void closestPt(const std::vector<Primitive>& primitives);
+
+	void closestPt(const std::vector<Primitive>& primitives, const std::vector<int>& candidates);
 
 };
 #endif
@@ -9,193 +9,223 @@
 #include <iostream>
 #include <cmath>
 #include <vector>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 #include <glm/glm.hpp>
 #include "Sphere.h"
 #include "Cylinder.h"
 #include "TruncatedCone.h"
 #include "Torus.h"
 #include "SceneObject.h"
-#include "Ray.h"
 #include "Plane.h"
-#include "TextureBMP.h"
+#include "Scene.h"
+#include "Renderer.h"
+#include "RenderJob.h"
+#include "ThreadPool.h"
+#include "FrameGovernor.h"
+#include "Denoiser.h"
+#include "Camera.h"
+#include "Reprojection.h"
+#include "PixelCost.h"
+#include "ImageIO.h"
 #include <GL/freeglut.h>
 using namespace std;
 
 const float EDIST = 40.0;
-const int NUMDIV = 500;
-const int MAX_STEPS = 5;
-const int SAMPLES_PER_PIXEL = 4;
+const int MAX_NUMDIV = 500;
+const int MIN_NUMDIV = 50;
+const int MAX_SAMPLES_PER_PIXEL = 4;
 const float XMIN = -10.0;
 const float XMAX = 10.0;
 const float YMIN = -10.0;
 const float YMAX = 10.0;
-static std::vector<glm::vec3> lightPositions;
-const float ambientTerm = 0.2f;
+const int REFINE_ROWS = 25;        //Rows of stale pixels re-traced per frame after a camera move
+const float MOVE_STEP = 2.0f;      //Camera translation per key press
+const float TURN_SPEED = 0.2f;     //Degrees of camera rotation per pixel of mouse drag
 bool enableAA = true;
+bool enableGovernor = true;
+bool enableDenoise = false;        //1 sample + filter: a preview, not as accurate as AA
+bool enableReprojection = true;
+bool enableRasterVisibility = true;
+bool enableTileCulling = true;
+bool enableFastMath = FAST_MATH_DEFAULT;
+
+int numDiv = MAX_NUMDIV;                         //Cells per side for the current frame
+int samplesPerPixel = MAX_SAMPLES_PER_PIXEL;     //AA samples per cell for the current frame
+FrameGovernor governor(50.0f, MIN_NUMDIV, MAX_NUMDIV, (int)std::sqrt(MAX_SAMPLES_PER_PIXEL));
+GBuffer frame;                     //Raw traced image of the current frame
+GBuffer prevFrame;                 //Raw traced image of the previous frame
+GBuffer denoised;
+Denoiser denoiser;
+Camera camera(EDIST, XMIN, XMAX, YMIN, YMAX);
+bool cameraMoved = false;          //Set by the input callbacks, cleared by display()
+std::vector<char> fresh;           //Per pixel: traced from the current camera (not reprojected)
+int staleRows = 0;                 //Rows from refineRow onwards may still hold reprojected pixels
+int refineRow = 0;
+int mouseX = 0, mouseY = 0;
+
+std::shared_ptr<Scene> scene;
+ThreadPool pool;
+
+
+//---Renders the whole frame into the G-buffer ------------------------------------------
+//   The frame is rendered as a job on the thread pool, tile by tile.  Returns the number
+//   of pixels traced.
+//---------------------------------------------------------------------------------------
+int render(int n) {
+    RenderSettings settings;
+    settings.camera = camera;
+    settings.div = numDiv;
+    settings.grid = n;
+    settings.rasterVisibility = enableRasterVisibility;
+    settings.tileCulling = enableTileCulling;
+    settings.fastMath = enableFastMath;
+
+    std::shared_ptr<RenderJob> job = RenderJob::start(pool, scene, settings);
+    job->wait();
+    frame = job->snapshot();
+    fresh.assign(numDiv * numDiv, 1);
+    staleRows = 0;
+    return numDiv * numDiv;
+}
 
-vector<SceneObject*> sceneObjects;
-TextureBMP texture;
-
-//---The most important function in a ray tracer! ---------------------------------- 
-//   Computes the colour value obtained by tracing a ray and finding its 
-//     closest point of intersection with objects in the scene.
-//----------------------------------------------------------------------------------
-glm::vec3 trace(Ray ray, int step) {
-    ray.closestPt(sceneObjects);
-    if (ray.index < 0) return glm::vec3(0.0f);
-
-    SceneObject* obj = sceneObjects[ray.index];
-    glm::vec3  hit   = ray.hit;
-
-    if (ray.index == 6) {
-        int stripeW = 5;
-        int ix = int(floor(hit.x/stripeW));
-        int iz = int(floor(hit.z/stripeW));
-        glm::vec3 stripeCol = ((ix+iz)&1)
-            ? glm::vec3(0,1,0)
-            : glm::vec3(1,1,0.5f);
-        obj->setColor(stripeCol);
+//---Traces the pixels of rows [j0, j1) that are not marked fresh -----------------------
+//   The rows are split into bands that run as tasks on the thread pool.  Returns the
+//   number of pixels traced.
+//---------------------------------------------------------------------------------------
+int traceStale(int n, int j0, int j1) {
+    const int BAND = 8;
+    RenderContext ctx{ scene.get(), &camera, numDiv, n, &frame };
+    if (enableFastMath) scene->prepareFastMath();
+    PixelKernel kernel = selectKernel(scene->features, n, enableFastMath);
+    std::mutex mutex;
+    std::condition_variable finished;
+    int left = (j1 - j0 + BAND - 1) / BAND;
+    for (int b0 = j0; b0 < j1; b0 += BAND) {
+        int b1 = std::min(b0 + BAND, j1);
+        pool.submit(0, [&, b0, b1] {
+            for (int j = b0; j < b1; ++j)
+                for (int i = 0; i < numDiv; ++i)
+                    if (!fresh[j * numDiv + i]) kernel(ctx, i, j);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--left == 0) finished.notify_all();
+        });
     }
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return left == 0; });
+    return int(std::count(fresh.begin() + j0 * numDiv, fresh.begin() + j1 * numDiv, 0));
+}
 
-    if (ray.index == 0) {
-        glm::vec3 N = obj->normal(hit);
-        float u = 0.5f + atan2(N.z, N.x)/(2.0f*M_PI);
-        float v = 0.5f - asin(N.y)/M_PI;
-        obj->setColor(texture.getColorAt(u,v));
+//---Builds the frame after a camera move from the previous one -------------------------
+//   Pixels on reflective, refractive, transparent or specular surfaces change with the
+//   view, so they are traced again together with the holes left by reprojection.
+//   Everything reused is marked stale and re-traced by refine() on the following frames.
+//---------------------------------------------------------------------------------------
+int renderReprojected(int n) {
+    std::vector<char> viewDependent(scene->objects.size());
+    for (size_t k = 0; k < scene->objects.size(); k++) {
+        SceneObject* obj = scene->objects[k];
+        viewDependent[k] = obj->isReflective() || obj->isRefractive() || obj->isTransparent()
+                        || obj->isSpecular();
     }
 
-    glm::vec3 baseCol = obj->getColor();
-    glm::vec3 N = obj->normal(hit);
-    glm::vec3 V = glm::normalize(-ray.dir);
-
-    glm::vec3 color = ambientTerm * baseCol;
-
-    float lightScale = 1.0f / float(lightPositions.size());
-    for (auto& Lpos : lightPositions) {
-        glm::vec3 L     = glm::normalize(Lpos - hit);
-        Ray shadow(hit, L);
-        shadow.closestPt(sceneObjects);
-
-        float NdotL     = glm::max(glm::dot(N, L), 0.0f);
-        glm::vec3 diff  = NdotL * baseCol;
-        glm::vec3 spec(0.0f);
-        if (obj->isSpecular()) {
-            glm::vec3 R    = glm::reflect(-L, N);
-            float     RV   = glm::max(glm::dot(R, V), 0.0f);
-            spec           = glm::vec3(powf(RV, obj->getShininess()));
-        }
+    std::swap(prevFrame, frame);
+    frame.resize(numDiv, numDiv);
+    reproject(prevFrame, camera, viewDependent, frame, fresh);
+    int traced = traceStale(n, 0, numDiv);
 
-        glm::vec3 contrib(0.0f);
-        if (shadow.index < 0) {
-            contrib = diff + spec;
-        }
-        else {
-            SceneObject* blocker = sceneObjects[shadow.index];
-            float factor = 0.0f;
-            if (blocker->isTransparent()) {
-                factor = blocker->getTransparencyCoeff() / 1.5;
-            }
-            else if (blocker->isRefractive()) {
-                factor = blocker->getRefractionCoeff() / 1.5;
-            }
-            contrib = factor * (diff + spec);
-        }
-        color += lightScale * contrib;
-    }
+    for (int p = 0; p < numDiv * numDiv; p++) fresh[p] = !fresh[p];
+    staleRows = numDiv;
+    refineRow = 0;
+    return traced;
+}
 
-    if (obj->isReflective() && step < MAX_STEPS) {
-        float kr = obj->getReflectionCoeff();
-        glm::vec3 R = glm::reflect(ray.dir, N);
-        Ray rray(hit, R); rray.closestPt(sceneObjects);
-        if (rray.index > -1)
-            color += kr * trace(rray, step+1);
-    }
-    if (obj->isRefractive() && step < MAX_STEPS) {
-        float kr = obj->getRefractionCoeff();
-        float eta = obj->getRefractiveIndex();
-        glm::vec3 nrm = N;
-        float n1=1, n2=eta;
-
-        if (glm::dot(ray.dir,nrm)>0){ nrm=-nrm; std::swap(n1,n2); }
-
-        glm::vec3 rd = glm::normalize(glm::refract(ray.dir,nrm,n1/n2));
-        Ray through(hit, rd); through.closestPt(sceneObjects);
-
-        if (through.index > -1) {
-            glm::vec3 exitPt = through.hit;
-            glm::vec3 N2     = sceneObjects[through.index]->normal(exitPt);
-            if (glm::dot(rd,N2)>0) N2=-N2;
-            glm::vec3 rd2 = glm::normalize(glm::refract(rd,N2,n2/n1));
-            Ray exitRay(exitPt, rd2); exitRay.closestPt(sceneObjects);
-            if (exitRay.index > -1)
-                color += kr * trace(exitRay, step+1);
-        }
-    }
-    if (obj->isTransparent() && step < MAX_STEPS) {
-        float rho = obj->getTransparencyCoeff();
-        Ray t1(hit, ray.dir); t1.closestPt(sceneObjects);
-        if (t1.index>-1) {
-            Ray t2(t1.hit, ray.dir);
-            color += rho * trace(t2, step+1);
-        }
-    }
+//---Re-traces the next band of stale pixels while the camera is still ------------------
+int refine(int n) {
+    int end = std::min(refineRow + REFINE_ROWS, numDiv);
+    int traced = traceStale(n, refineRow, end);
+    std::fill(fresh.begin() + refineRow * numDiv, fresh.begin() + end * numDiv, 1);
+    staleRows -= end - refineRow;
+    refineRow = end;
+    return traced;
+}
 
-    return glm::clamp(color, glm::vec3(0.0f), glm::vec3(1.0f));
+
+//---Writes per-pixel cost maps of the current view -------------------------------------
+//   The view is rendered again at full resolution on this thread alone, so the timings
+//   are not disturbed by other work, and saved with its cost maps as profile-*.ppm/.pfm
+//   in the working directory.
+//---------------------------------------------------------------------------------------
+void profile() {
+    int n = enableAA ? (int)std::sqrt(MAX_SAMPLES_PER_PIXEL) : 1;
+    GBuffer image;
+    image.resize(MAX_NUMDIV, MAX_NUMDIV);
+    CostBuffer cost;
+    cost.resize(MAX_NUMDIV, MAX_NUMDIV);
+
+    RenderContext ctx{ scene.get(), &camera, MAX_NUMDIV, n, &image };
+    ctx.fastMath = enableFastMath;
+    profileRegion(ctx, 0, 0, MAX_NUMDIV, MAX_NUMDIV, cost);
+    writePPM("profile-beauty.ppm", image);
+    if (writeCostMaps("profile", cost))
+        cout << "Wrote profile-beauty.ppm and the profile-* cost maps" << endl;
 }
 
 
 //---The main display module -----------------------------------------------------------
 // In a ray tracing application, it just displays the ray traced image by drawing
-// each cell as a quad.
+// each cell as a quad.  The number of cells and the AA grid come from the frame
+// governor, so a low-resolution frame is simply drawn with larger quads.  With the
+// denoiser on ('d', off by default), each cell gets a single sample and the filter
+// smooths the result: a quicker, softer preview, below the supersampled quality.
+// After a camera move the previous frame is reprojected instead of traced in full, and
+// the governor holds the resolution until its stale pixels have been re-traced.
 //---------------------------------------------------------------------------------------
-// at top of your .cpp, to toggle anti-aliasing:
-
 void display() {
-    float xp, yp;
-    float cellX = (XMAX - XMIN) / NUMDIV;
-    float cellY = (YMAX - YMIN) / NUMDIV;
-    glm::vec3 eye(0., 0., 0.);
+    bool refining = enableReprojection && !cameraMoved && staleRows > 0;
+    if (enableGovernor) {
+        governor.beginFrame(refining);
+        numDiv = governor.getNumDiv();
+        samplesPerPixel = governor.getGrid() * governor.getGrid();
+    }
+    else {
+        numDiv = MAX_NUMDIV;
+        samplesPerPixel = MAX_SAMPLES_PER_PIXEL;
+    }
 
-    const int SPP = SAMPLES_PER_PIXEL;  // e.g. 4
-    const int n   = (int)std::sqrt(SPP); // 2 if SPP==4
+    int n = (enableAA && !enableDenoise) ? (int)std::sqrt(samplesPerPixel) : 1;   //AA grid is n x n
+    bool sameSize = frame.width == numDiv;
+    int traced;                                //Pixels traced this frame, n x n samples each
+    if (enableReprojection && cameraMoved && frame.width > 0)
+        traced = renderReprojected(n);
+    else if (refining && sameSize)
+        traced = refine(n);
+    else
+        traced = render(n);
+    cameraMoved = false;
+
+    const GBuffer* shown = &frame;
+    if (enableDenoise) {
+        denoised = frame;
+        denoiser.apply(denoised, pool);
+        shown = &denoised;
+    }
+
+    float cellX = (XMAX - XMIN) / numDiv;
+    float cellY = (YMAX - YMIN) / numDiv;
 
     glClear(GL_COLOR_BUFFER_BIT);
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
     glBegin(GL_QUADS);
 
-    for (int i = 0; i < NUMDIV; ++i) {
-        xp = XMIN + i * cellX;
-        for (int j = 0; j < NUMDIV; ++j) {
-            yp = YMIN + j * cellY;
-
-            glm::vec3 color(0.0f);
-
-            if (enableAA) {
-                glm::vec3 accum(0.0f);
-                for (int sx = 0; sx < n; ++sx) {
-                    for (int sy = 0; sy < n; ++sy) {
-                        float u = (sx + 0.5f) / float(n);
-                        float v = (sy + 0.5f) / float(n);
-
-                        glm::vec3 dir(
-                            xp + u * cellX,
-                            yp + v * cellY,
-                            -EDIST
-                        );
-                        accum += trace(Ray(eye, dir), 1);
-                    }
-                }
-                color = accum / 4.0f;
-            }
-            else {
-                glm::vec3 dir(
-                    xp + 0.5f * cellX,
-                    yp + 0.5f * cellY,
-                    -EDIST
-                );
-                color = trace(Ray(eye, dir), 1);
-            }
+    for (int j = 0; j < numDiv; ++j) {
+        float yp = YMIN + j * cellY;
+        for (int i = 0; i < numDiv; ++i) {
+            float xp = XMIN + i * cellX;
+            glm::vec3 color = shown->color[j * numDiv + i];
 
             glColor3f(color.r, color.g, color.b);
             glVertex2f(xp,          yp);
@@ -207,6 +237,77 @@ void display() {
 
     glEnd();
     glFlush();
+
+    if (enableGovernor) {
+        governor.endFrame(float(traced) * n * n);
+        if (!governor.isConverged()) glutPostRedisplay();   //Keep refining while the view is still
+    }
+    if (staleRows > 0) glutPostRedisplay();
+}
+
+
+//---Window, keyboard and mouse callbacks -----------------------------------------------
+//   'g' toggles the frame governor, 'a' toggles anti-aliasing, 'd' toggles the
+//   denoiser, 'r' toggles reprojection, 'v' toggles the rasterized visibility pass,
+//   'c' toggles tile culling, 'f' toggles fast-math shading, 'p' writes per-pixel cost
+//   maps of the view and '+'/'-' change the governor's target frame time.  The arrow keys move the
+//   camera, Page Up/Down raise and lower it, and dragging with the left mouse button
+//   turns it.
+//---------------------------------------------------------------------------------------
+void reshape(int w, int h) {
+    glViewport(0, 0, w, h);
+    governor.viewChanged();
+}
+
+void keyboard(unsigned char key, int x, int y) {
+    switch (key) {
+        case 'g': enableGovernor = !enableGovernor; break;
+        case 'a': enableAA = !enableAA; break;
+        case 'd': enableDenoise = !enableDenoise; break;
+        case 'r': enableReprojection = !enableReprojection; break;
+        case 'v': enableRasterVisibility = !enableRasterVisibility; break;
+        case 'c': enableTileCulling = !enableTileCulling; break;
+        case 'f': enableFastMath = !enableFastMath; break;
+        case '+': governor.setTarget(governor.getTarget() * 1.5f); break;
+        case '-': governor.setTarget(governor.getTarget() / 1.5f); break;
+        case 'p': profile(); return;
+        default: return;
+    }
+    governor.viewChanged();
+    glutPostRedisplay();
+}
+
+void cameraChanged() {
+    cameraMoved = true;
+    governor.viewChanged();
+    glutPostRedisplay();
+}
+
+void special(int key, int x, int y) {
+    switch (key) {
+        case GLUT_KEY_UP:        camera.move(0, 0,  MOVE_STEP); break;
+        case GLUT_KEY_DOWN:      camera.move(0, 0, -MOVE_STEP); break;
+        case GLUT_KEY_LEFT:      camera.move(-MOVE_STEP, 0, 0); break;
+        case GLUT_KEY_RIGHT:     camera.move( MOVE_STEP, 0, 0); break;
+        case GLUT_KEY_PAGE_UP:   camera.move(0,  MOVE_STEP, 0); break;
+        case GLUT_KEY_PAGE_DOWN: camera.move(0, -MOVE_STEP, 0); break;
+        default: return;
+    }
+    cameraChanged();
+}
+
+void mouse(int button, int state, int x, int y) {
+    if (button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) {
+        mouseX = x;
+        mouseY = y;
+    }
+}
+
+void motion(int x, int y) {
+    camera.turn(TURN_SPEED * (x - mouseX), TURN_SPEED * (mouseY - y));
+    mouseX = x;
+    mouseY = y;
+    cameraChanged();
 }
 
 
@@ -222,69 +323,72 @@ void initialize() {
 
 	glClearColor(0, 0, 0, 1);
 
-	texture = TextureBMP("../Mars.bmp");
+	scene = std::make_shared<Scene>();
 
-	lightPositions.push_back(glm::vec3( 15.0f, 15.0f, -3.0f));
-    lightPositions.push_back(glm::vec3( 0.0f, 15.0f, -3.0f));
+	scene->addLight(glm::vec3( 15.0f, 15.0f, -3.0f));
+	scene->addLight(glm::vec3( 0.0f, 15.0f, -3.0f));
 
 	Sphere *sphere1 = new Sphere(glm::vec3(-7.0, -3.0, -70.0), 3.0);
 	sphere1->setColor(glm::vec3(0, 0, 1));
-	sceneObjects.push_back(sphere1);
+	sphere1->setTexture(scene->textures->load("../Mars.bmp"));
+	scene->add(sphere1);
 
 	Sphere *sphere2 = new Sphere(glm::vec3( 0.0, -3.0, -70.0), 3.0);
 	sphere2->setColor(glm::vec3(0.3, 0.3, 0.3));
 	sphere2->setReflectivity(true, 0.05);
 	sphere2->setTransparency(true, 0.9);
-	sceneObjects.push_back(sphere2);
+	scene->add(sphere2);
 
 	Sphere *sphere3 = new Sphere(glm::vec3( 7.0, -10.0, -70.0), 3.0);
 	sphere3->setColor(glm::vec3(0.1, 0.1, 0.1));  
 	sphere3->setReflectivity(true, 0.2);
 	sphere3->setRefractivity(true, 0.9, 1.5);
-	sceneObjects.push_back(sphere3);
+	scene->add(sphere3);
 
 	Cylinder *cylinder = new Cylinder(glm::vec3(-7.0, -10, -70.0), 2.0, 5.0);
 	cylinder->setColor(glm::vec3(0.3, 0.3, 0.3));
-	sceneObjects.push_back(cylinder);
+	scene->add(cylinder);
 
 	TruncatedCone *cone = new TruncatedCone(glm::vec3(0.0, -10, -70.0), 2.5, 1.0, 5);
 	cone->setColor(glm::vec3(0.75, 0.3, 0.75));
-	sceneObjects.push_back(cone);
+	scene->add(cone);
 
 	Torus *torus = new Torus(glm::vec3(7.0, -3.0, -70.0), 2.0, 1.0);
 	torus->setColor(glm::vec3(0, 1, 1));
-	sceneObjects.push_back(torus);
+	scene->add(torus);
 
 	Plane *floor = new Plane (glm::vec3(-20., -15, -40), glm::vec3(20., -15, -40), glm::vec3(20., -15, -200), glm::vec3(-20., -15, -200));
 	floor->setColor(glm::vec3(0.8, 0.8, 0));
 	floor->setSpecularity(false);
-	sceneObjects.push_back(floor);
+	scene->checkeredObject = scene->add(floor);
 
 	Plane *lWall = new Plane (glm::vec3(-20., -15, -40), glm::vec3(-20., -15, -200), glm::vec3(-20., 15, -200), glm::vec3(-20., 15, -40)); 
 	lWall->setColor(glm::vec3(1.0, 0, 0));
 	lWall->setSpecularity(false);
-	sceneObjects.push_back(lWall);
+	scene->add(lWall);
 
 	Plane *rWall = new Plane (glm::vec3(20., 15, -40), glm::vec3(20., 15, -200), glm::vec3(20., -15, -200), glm::vec3(20., -15, -40)); 
 	rWall->setColor(glm::vec3(0, 1.0, 1.0));
 	rWall->setSpecularity(false);
-	sceneObjects.push_back(rWall);
+	scene->add(rWall);
 
 	Plane *bWall = new Plane (glm::vec3(-20., -15, -200), glm::vec3(20., -15, -200), glm::vec3(20., 15, -200), glm::vec3(-20., 15, -200)); 
 	bWall->setSpecularity(false);
 	bWall->setColor(glm::vec3(0.173, 0.357, 0.369));
-	sceneObjects.push_back(bWall);
+	scene->add(bWall);
 
 	Plane *roof = new Plane (glm::vec3(-20., 15, -200), glm::vec3(20., 15, -200), glm::vec3(20., 15, -40), glm::vec3(-20., 15, -40));
 	roof->setColor(glm::vec3(1.0, 0, 1.0));
 	roof->setSpecularity(false);
-	sceneObjects.push_back(roof);
+	scene->add(roof);
 
 	Plane *mirror = new Plane (glm::vec3(-10., 1, -84), glm::vec3(10., 1, -84), glm::vec3(10., 10, -80), glm::vec3(-10., 10, -80)); 
 	mirror->setSpecularity(false);
 	mirror->setReflectivity(true, 0.8);
 	mirror->setColor(glm::vec3(0.1, 0.1, 0.1));
-	sceneObjects.push_back(mirror);
+	scene->add(mirror);
+
+	scene->finalize();
 }
 
 int main(int argc, char *argv[]) {
@@ -295,6 +399,11 @@ int main(int argc, char *argv[]) {
 	glutCreateWindow("Raytracing");
 
 	glutDisplayFunc(display);
+	glutReshapeFunc(reshape);
+	glutKeyboardFunc(keyboard);
+	glutSpecialFunc(special);
+	glutMouseFunc(mouse);
+	glutMotionFunc(motion);
 	initialize();
 
 	glutMainLoop();
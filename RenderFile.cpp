@@ -0,0 +1,62 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Offline renderer
+*  Renders a scene file straight to a PPM, streaming bands of
+*  the image to disk (StreamRender.h), so posters far larger
+*  than memory allows for a whole frame can be rendered.
+*
+*  Usage:  RenderFile.out scene out.ppm [-s size] [-t threads] [-w window]
+*  Example:  RenderFile.out room.scene poster.ppm -s 32768
+-------------------------------------------------------------*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "SceneParser.h"
+#include "StreamRender.h"
+
+int main(int argc, char *argv[]) {
+	if (argc < 3 || argc % 2 == 0) {
+		fprintf(stderr, "Usage: %s scene out.ppm [-s size] [-t threads] [-w window]\n", argv[0]);
+		return 1;
+	}
+	std::shared_ptr<Scene> scene = std::make_shared<Scene>();
+	RenderSettings settings;
+	bool denoise = false;
+	std::string error;
+	if (!loadSceneFile(argv[1], *scene, settings, denoise, error)) {
+		fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+
+	int threads = 0, window = 4;
+	for (int a = 3; a + 1 < argc; a += 2) {
+		int value = atoi(argv[a + 1]);
+		if      (strcmp(argv[a], "-s") == 0) settings.div = value;
+		else if (strcmp(argv[a], "-t") == 0) threads = value;
+		else if (strcmp(argv[a], "-w") == 0) window = value;
+		else {
+			fprintf(stderr, "Unknown option %s\n", argv[a]);
+			return 1;
+		}
+	}
+	if (settings.div <= 0) {
+		fprintf(stderr, "Bad size %d\n", settings.div);
+		return 1;
+	}
+	if (denoise) fprintf(stderr, "Denoising is not available when streaming; ignored\n");
+
+	ThreadPool pool(threads);
+	StreamStats stats;
+	auto start = std::chrono::steady_clock::now();
+	if (!streamRender(pool, scene, settings, argv[2], window, error, &stats)) {
+		fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	printf("%dx%d in %.0f ms: %d bands, peak %.1f MB of bands held\n",
+	       settings.div, settings.div, ms, stats.bands, stats.peakBytes / 1048576.0);
+	return 0;
+}
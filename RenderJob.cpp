@@ -0,0 +1,165 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The RenderJob class
+*  Each tile is traced into a private buffer and copied into
+*  the job's image under a lock, so snapshot() always sees
+*  whole tiles.  Tasks hold a shared_ptr to the job, so a
+*  job stays alive until its last tile has run even if the
+*  caller drops its handle.  A tile that throws fails the job
+*  instead of escaping into the pool's worker: the remaining
+*  tiles are skipped and wait() returns false.
+-------------------------------------------------------------*/
+
+#include "RenderJob.h"
+#include "Renderer.h"
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+RenderJob::RenderJob(std::shared_ptr<const Scene> scene, const RenderSettings& settings,
+                     TileCallback onTile)
+	: scene_(scene), settings_(settings), onTile_(onTile)
+{
+	image_.resize(settings.div, settings.div);
+}
+
+/**
+* Creates a job and queues all its tiles on the pool.  Returns immediately.
+*/
+std::shared_ptr<RenderJob> RenderJob::start(ThreadPool& pool, std::shared_ptr<const Scene> scene,
+                                            const RenderSettings& settings, TileCallback onTile)
+{
+	std::shared_ptr<RenderJob> job = std::make_shared<RenderJob>(scene, settings, onTile);
+	int div = settings.div, ts = settings.tileSize;
+	int tiles = (div + ts - 1) / ts;
+	job->tilesTotal_ = tiles * tiles;
+	for (int tj = 0; tj < tiles; tj++) {
+		for (int ti = 0; ti < tiles; ti++) {
+			int i0 = ti * ts, j0 = tj * ts;
+			int i1 = std::min(i0 + ts, div), j1 = std::min(j0 + ts, div);
+			pool.submit(settings.priority, [job, i0, j0, i1, j1] { job->renderTile(i0, j0, i1, j1); });
+		}
+	}
+	return job;
+}
+
+void RenderJob::renderTile(int i0, int j0, int i1, int j1) {
+	if (!cancelled_) {
+		try {
+			GBuffer tile;
+			tile.resize(i1 - i0, j1 - j0);
+			RenderContext ctx{ scene_.get(), &settings_.camera, settings_.div, settings_.grid, &tile, i0, j0 };
+			ctx.fastMath = settings_.fastMath;
+			CullStats stats;
+			renderRegion(ctx, i0, j0, i1, j1, settings_.rasterVisibility, settings_.tileCulling, &stats);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				cullStats_.merge(stats);
+				for (int j = j0; j < j1; j++) {
+					for (int i = i0; i < i1; i++) {
+						int src = (j - j0) * tile.width + (i - i0);
+						image_.color[j * image_.width + i] = tile.color[src];
+						image_.features[j * image_.width + i] = tile.features[src];
+					}
+				}
+			}
+			tilesRendered_++;
+			if (onTile_) onTile_(*this, i0, j0, i1, j1);
+		}
+		catch (const std::exception& e) {
+			fail(e.what());
+		}
+		catch (...) {
+			fail("unknown error");
+		}
+	}
+
+	if (++tilesDone_ == tilesTotal_) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		finished_.notify_all();
+	}
+}
+
+/**
+* Records the first failure and skips the tiles not yet started.
+*/
+void RenderJob::fail(const std::string& error) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!failed_) error_ = error;
+	failed_ = true;
+	cancelled_ = true;
+}
+
+/**
+* Tiles not yet started are skipped; tiles in progress run to completion.
+*/
+void RenderJob::cancel() {
+	cancelled_ = true;
+}
+
+/**
+* Blocks until every tile has been rendered or skipped.  Returns false if a
+* tile failed; getError() says why.
+*/
+bool RenderJob::wait() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	finished_.wait(lock, [this] { return tilesDone_ == tilesTotal_; });
+	return !failed_;
+}
+
+bool RenderJob::isDone() const {
+	return tilesDone_ == tilesTotal_;
+}
+
+bool RenderJob::isCancelled() const {
+	return cancelled_;
+}
+
+bool RenderJob::isFailed() const {
+	return failed_;
+}
+
+std::string RenderJob::getError() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return error_;
+}
+
+/**
+* Fraction of tiles rendered so far, in [0, 1].
+*/
+float RenderJob::progress() const {
+	return tilesTotal_ ? float(tilesRendered_) / tilesTotal_ : 1.0f;
+}
+
+/**
+* Copy of the image as it stands; unfinished tiles are black.
+*/
+GBuffer RenderJob::snapshot() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return image_;
+}
+
+/**
+* Moves the image out of the job without copying it, leaving the job's image
+* empty.  Call once wait() has returned.
+*/
+GBuffer RenderJob::takeImage() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	GBuffer image = std::move(image_);
+	image_ = GBuffer();
+	return image;
+}
+
+/**
+* Candidate list lengths of the tiles rendered so far.
+*/
+CullStats RenderJob::getCullStats() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return cullStats_;
+}
+
+const RenderSettings& RenderJob::getSettings() const {
+	return settings_;
+}
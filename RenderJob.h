@@ -0,0 +1,88 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The RenderJob class
+*  A render of a shared Scene running asynchronously on a
+*  ThreadPool.  The image is split into square tiles, each a
+*  separate pool task carrying the job's priority, so many jobs
+*  interleave on one pool: small high-priority previews overtake
+*  the tiles of a large final render.
+*
+*  Usage:
+*      auto job = RenderJob::start(pool, scene, settings);
+*      ...  job->progress(), job->snapshot(), job->cancel()
+*      if (!job->wait()) ... job->getError()
+*      GBuffer image = job->takeImage();
+-------------------------------------------------------------*/
+
+#ifndef H_RENDER_JOB
+#define H_RENDER_JOB
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "Scene.h"
+#include "Camera.h"
+#include "Denoiser.h"
+#include "ThreadPool.h"
+#include "Culling.h"
+#include "Renderer.h"
+
+struct RenderSettings {
+	Camera camera = Camera(40.0f, -10.0f, 10.0f, -10.0f, 10.0f);
+	int  div = 500;                  //The image is div x div pixels
+	int  grid = 2;                   //AA: grid x grid samples per pixel
+	int  tileSize = 32;              //Pixels per tile side
+	int  priority = 0;               //Higher runs first
+	bool rasterVisibility = true;    //Use the rasterized primary-visibility pass
+	bool tileCulling = true;         //Test only each tile's candidate objects
+	bool fastMath = FAST_MATH_DEFAULT;   //Shade with the FastMath.h approximations
+};
+
+class RenderJob;
+
+//Called on a worker thread after each finished tile [i0, i1) x [j0, j1)
+typedef std::function<void(RenderJob& job, int i0, int j0, int i1, int j1)> TileCallback;
+
+class RenderJob {
+private:
+	std::shared_ptr<const Scene> scene_;
+	RenderSettings settings_;
+	TileCallback onTile_;
+	GBuffer image_;
+	CullStats cullStats_;
+	int tilesTotal_ = 0;
+	std::atomic<int> tilesDone_{0};      //Rendered or skipped
+	std::atomic<int> tilesRendered_{0};
+	std::atomic<bool> cancelled_{false};
+	std::atomic<bool> failed_{false};
+	std::string error_;                  //Why the first failed tile failed
+	mutable std::mutex mutex_;           //Guards image_, cullStats_ and error_
+	std::condition_variable finished_;
+
+	void renderTile(int i0, int j0, int i1, int j1);
+	void fail(const std::string& error);
+
+public:
+	RenderJob(std::shared_ptr<const Scene> scene, const RenderSettings& settings, TileCallback onTile);
+
+	static std::shared_ptr<RenderJob> start(ThreadPool& pool, std::shared_ptr<const Scene> scene,
+	                                        const RenderSettings& settings, TileCallback onTile = nullptr);
+
+	void  cancel();
+	bool  wait();
+	bool  isDone() const;
+	bool  isCancelled() const;
+	bool  isFailed() const;
+	std::string getError() const;
+	float progress() const;
+	GBuffer snapshot() const;
+	GBuffer takeImage();
+	CullStats getCullStats() const;
+	const RenderSettings& getSettings() const;
+};
+
+#endif //!H_RENDER_JOB
@@ -0,0 +1,370 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The RenderServer class
+*  One thread per connection reads the request and waits for
+*  its result; the rendering itself runs on the shared pool.
+*  The result cache holds futures, so a request that arrives
+*  while the same image is rendering waits for that render.
+*  Failed requests are answered but not cached; a render that
+*  throws, on this thread or in a tile on the pool, is answered
+*  with "ERR" like any other failure.  Cache
+*  entries keep their canonical text, so a hash collision is
+*  rendered afresh instead of answered with the wrong image.
+*  The path, size and modification time of each texture are
+*  appended to the scene text, so a texture rewritten on disk
+*  gives new keys for both the image and the parsed scene.
+-------------------------------------------------------------*/
+
+#include "RenderServer.h"
+#include "RenderJob.h"
+#include "SceneParser.h"
+#include "ImageIO.h"
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const size_t MAX_REQUEST = 1u << 20;   //Bytes
+static const int RECV_TIMEOUT = 10;           //Seconds a client may stay silent
+
+/**
+* 64-bit FNV-1a hash of 'text'.  Pass a previous hash as 'seed' to chain texts.
+*/
+uint64_t hashText(const std::string& text, uint64_t seed) {
+	uint64_t h = seed;
+	for (unsigned char c : text) {
+		h ^= c;
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+static std::string toHex(uint64_t key) {
+	char buf[17];
+	snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)key);
+	return buf;
+}
+
+//One line per texture line of the canonical 'sceneText', naming the file's identity
+static std::string textureIdentities(TextureManager& textures, const std::string& sceneText) {
+	std::istringstream in(sceneText);
+	std::string line, identities;
+	while (std::getline(in, line)) {
+		if (line.compare(0, 8, "texture ") != 0) continue;
+		identities += "#texture " + textures.identify(line.substr(8)) + "\n";
+	}
+	return identities;
+}
+
+//Memory a render of a div x div image holds: the job's buffer, the PPM
+//it is encoded into and, when denoising, the denoiser's working planes
+static size_t imageBytes(int div, bool denoise) {
+	size_t perPixel = sizeof(glm::vec3) + sizeof(PixelFeatures) + 3;
+	return size_t(div) * div * perPixel + (denoise ? Denoiser::scratchBytes(div, div) : 0);
+}
+
+RenderServer::RenderServer(const ServerSettings& settings)
+	: settings_(settings), pool_(settings.threads),
+	  textures_(std::make_shared<TextureManager>(settings.textureBytes))
+{
+	textures_->confine(settings.textureDir);
+}
+
+RenderServer::~RenderServer() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	idle_.wait(lock, [this] { return clients_ == 0; });   //Their threads use this object
+	if (listenFd_ >= 0) close(listenFd_);
+}
+
+/**
+* Binds to 127.0.0.1 on the configured port.  Only local clients can connect.
+*/
+bool RenderServer::listen(std::string& error) {
+	listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+	if (listenFd_ < 0) {
+		error = "cannot create socket";
+		return false;
+	}
+	int on = 1;
+	setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+	sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(settings_.port);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(listenFd_, (sockaddr*)&addr, sizeof(addr)) < 0 || ::listen(listenFd_, 64) < 0) {
+		error = "cannot listen on port " + std::to_string(settings_.port);
+		return false;
+	}
+	socklen_t len = sizeof(addr);
+	if (getsockname(listenFd_, (sockaddr*)&addr, &len) == 0) settings_.port = ntohs(addr.sin_port);
+	return true;
+}
+
+/**
+* Accepts connections until stop() is called.  Clients still being served
+* are finished by their own threads.
+*/
+void RenderServer::run() {
+	while (true) {
+		int fd = accept(listenFd_, nullptr, nullptr);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) continue;
+			if (errno == EBADF || errno == EINVAL || errno == ENOTSOCK) return;   //Stopped
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));   //Out of descriptors or memory
+			continue;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (clients_ >= settings_.maxClients) {
+				static const char busy[] = "ERR busy\n";
+				send(fd, busy, sizeof(busy) - 1, MSG_NOSIGNAL);
+				close(fd);
+				continue;
+			}
+			clients_++;
+		}
+		std::thread(&RenderServer::serve, this, fd).detach();
+	}
+}
+
+/**
+* Makes run() return.  May be called from any thread.
+*/
+void RenderServer::stop() {
+	shutdown(listenFd_, SHUT_RDWR);
+}
+
+int RenderServer::getPort() const {
+	return settings_.port;
+}
+
+ServerStats RenderServer::getStats() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return stats_;
+}
+
+void RenderServer::serve(int fd) {
+	timeval timeout = { RECV_TIMEOUT, 0 };
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	//Read until the client shuts down its side or sends an "end" line
+	std::string request;
+	char buf[4096];
+	bool complete = false;
+	size_t lineStart = 0;
+	while (!complete && request.size() <= MAX_REQUEST) {
+		ssize_t n = recv(fd, buf, sizeof(buf), 0);
+		if (n < 0) break;
+		if (n == 0) { complete = true; break; }
+		request.append(buf, n);
+		for (size_t eol; !complete && (eol = request.find('\n', lineStart)) != std::string::npos;
+		     lineStart = eol + 1) {
+			std::string line = request.substr(lineStart, eol - lineStart);
+			if (!line.empty() && line.back() == '\r') line.pop_back();
+			if (line == "end") {
+				request.erase(lineStart);
+				complete = true;
+			}
+		}
+	}
+
+	std::string response;
+	if (request.size() > MAX_REQUEST) response = "ERR request too large\n";
+	else if (!complete) response = "ERR incomplete request\n";
+	else response = handle(request);
+	if (response.compare(0, 3, "ERR") == 0) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		stats_.errors++;
+	}
+
+	for (size_t sent = 0; sent < response.size(); ) {
+		ssize_t n = send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+		if (n <= 0) break;
+		sent += n;
+	}
+	close(fd);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (--clients_ == 0) idle_.notify_all();
+}
+
+/**
+* Returns the response to one request: a PPM image or an "ERR" line.
+*/
+std::string RenderServer::handle(const std::string& request) {
+	std::string sceneText, settingsText, error;
+	splitDescription(request, sceneText, settingsText);
+	if (sceneText.empty()) return "ERR empty scene\n";
+	sceneText += textureIdentities(*textures_, sceneText);
+
+	RenderSettings rs;
+	bool denoise = false;
+	if (!parseDescription(request, nullptr, &rs, &denoise, error)) return "ERR " + error + "\n";
+	if (rs.div < 1 || rs.div > settings_.maxDiv || rs.grid < 1 || rs.grid > 8)
+		return "ERR size or samples out of range\n";
+	if (imageBytes(rs.div, denoise) > settings_.renderBytes)
+		return "ERR image too large for the render memory budget\n";
+
+	uint64_t key = hashText(settingsText, hashText(sceneText));
+	std::string text = std::to_string(sceneText.size()) + ":" + sceneText + settingsText;
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	auto it = results_.find(key);
+	if (it != results_.end() && it->second.text != text) {
+		lock.unlock();
+		std::cerr << toHex(key) << " hash collision, not cached" << std::endl;
+		return renderSafely(key, request, sceneText);
+	}
+	if (it != results_.end()) {
+		resultLru_.splice(resultLru_.begin(), resultLru_, it->second.lru);
+		std::shared_future<std::string> data = it->second.data;
+		bool ready = it->second.bytes > 0;
+		if (ready) stats_.hits++;
+		else stats_.joins++;
+		lock.unlock();
+		std::cerr << toHex(key) << (ready ? " cached" : " joined") << std::endl;
+		return data.get();
+	}
+
+	std::promise<std::string> promise;
+	resultLru_.push_front(key);
+	Result& entry = results_[key];
+	entry.text = text;
+	entry.data = promise.get_future().share();
+	entry.lru = resultLru_.begin();
+	lock.unlock();
+
+	std::string response = renderSafely(key, request, sceneText);
+	promise.set_value(response);
+
+	lock.lock();
+	it = results_.find(key);
+	if (response.compare(0, 3, "ERR") == 0) {
+		resultLru_.erase(it->second.lru);
+		results_.erase(it);
+	}
+	else {
+		it->second.bytes = response.size() + text.size();
+		cachedBytes_ += it->second.bytes;
+		evict();
+	}
+	return response;
+}
+
+/**
+* render(), with an exception (out of memory, say) turned into an "ERR"
+* response, so the waiters on its cache entry are answered too.
+*/
+std::string RenderServer::renderSafely(uint64_t key, const std::string& request, const std::string& sceneText) {
+	try {
+		return render(key, request, sceneText);
+	}
+	catch (const std::exception& e) {
+		std::cerr << toHex(key) << " failed: " << e.what() << std::endl;
+		return std::string("ERR render failed: ") + e.what() + "\n";
+	}
+	catch (...) {
+		return "ERR render failed\n";
+	}
+}
+
+/**
+* Renders a request that is not in the cache.  Waits for a free render slot
+* once the scene is ready.
+*/
+std::string RenderServer::render(uint64_t key, const std::string& request, const std::string& sceneText) {
+	std::shared_ptr<const Scene> scene;
+	std::string error;
+	{
+		uint64_t sceneKey = hashText(sceneText);
+		std::unique_lock<std::mutex> lock(mutex_);
+		auto it = scenes_.find(sceneKey);
+		if (it != scenes_.end() && it->second.text == sceneText) {
+			sceneLru_.splice(sceneLru_.begin(), sceneLru_, it->second.lru);
+			scene = it->second.scene;
+		}
+		else {
+			lock.unlock();
+			std::shared_ptr<Scene> parsed = std::make_shared<Scene>();
+			parsed->textures = textures_;
+			if (!parseDescription(request, parsed.get(), nullptr, nullptr, error))
+				return "ERR " + error + "\n";
+			scene = parsed;
+
+			lock.lock();
+			if (scenes_.find(sceneKey) == scenes_.end()) {
+				sceneLru_.push_front(sceneKey);
+				scenes_[sceneKey] = CachedScene{ sceneText, scene, sceneLru_.begin() };
+				if (scenes_.size() > settings_.maxScenes) {
+					scenes_.erase(sceneLru_.back());
+					sceneLru_.pop_back();
+				}
+			}
+		}
+	}
+
+	RenderSettings rs;
+	bool denoise = false;
+	parseDescription(request, nullptr, &rs, &denoise, error);
+
+	//Gives the render slot and its memory back however the render ends
+	struct Slot {
+		RenderServer& server;
+		size_t bytes;
+		~Slot() {
+			{
+				std::lock_guard<std::mutex> lock(server.mutex_);
+				server.rendering_--;
+				server.renderingBytes_ -= bytes;
+			}
+			server.slotFree_.notify_all();
+		}
+	};
+
+	size_t bytes = imageBytes(rs.div, denoise);
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		slotFree_.wait(lock, [this, bytes] {
+			return rendering_ < settings_.maxRenders && renderingBytes_ + bytes <= settings_.renderBytes;
+		});
+		rendering_++;
+		renderingBytes_ += bytes;
+		stats_.renders++;
+	}
+	Slot slot{ *this, bytes };
+	std::shared_ptr<RenderJob> job = RenderJob::start(pool_, scene, rs);
+	if (!job->wait()) throw std::runtime_error(job->getError());
+	GBuffer image = job->takeImage();
+	CullStats cull = job->getCullStats();
+	job.reset();
+
+	if (denoise) Denoiser().apply(image, pool_, rs.priority);
+	std::cerr << toHex(key) << " rendered " << rs.div << "x" << rs.div << ", candidates per tile: "
+	          << cull.meanPrimary() << " primary, " << cull.meanShadow() << " shadow, of "
+	          << cull.objects << std::endl;
+	return encodePPM(image, "key " + toHex(key));
+}
+
+/**
+* Drops the least recently used finished images until the cache fits its
+* budget.  Must be called with mutex_ held.
+*/
+void RenderServer::evict() {
+	auto it = resultLru_.end();
+	while (cachedBytes_ > settings_.cacheBytes && it != resultLru_.begin()) {
+		--it;
+		auto entry = results_.find(*it);
+		if (entry->second.bytes == 0) continue;   //Still rendering
+		cachedBytes_ -= entry->second.bytes;
+		results_.erase(entry);
+		it = resultLru_.erase(it);
+	}
+}
@@ -0,0 +1,113 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The RenderServer class
+*  A render daemon on a local TCP socket.  A client sends a
+*  scene description (SceneParser.h) and closes its side of the
+*  connection, or ends the text with a line holding "end"; the
+*  server answers with a binary PPM, or with one "ERR ..." line.
+*
+*  Results are content addressed: the key is a hash of the
+*  canonical scene and settings text, so repeated requests are
+*  answered from memory, and identical requests arriving together
+*  share one render.  Parsed scenes are kept too, so a new camera
+*  or resolution for a known scene skips parsing and set-up.
+*  All scenes load textures through one TextureManager, so a
+*  texture used by many scenes is held once, within one budget.
+*  Clients may only name textures inside textureDir; with no
+*  directory set, the texture keyword is refused.
+*  At most maxRenders requests render at once, and only while
+*  their images fit in renderBytes; a request whose image alone
+*  would not fit is refused.  Connections past maxClients are
+*  turned away with "ERR busy".  Port 0 listens on a free port,
+*  given by getPort() once listening.
+-------------------------------------------------------------*/
+
+#ifndef H_RENDER_SERVER
+#define H_RENDER_SERVER
+
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "Scene.h"
+#include "ThreadPool.h"
+
+struct ServerSettings {
+	int    port = 5363;
+	int    threads = 0;                  //Render threads; 0 means one per hardware thread
+	int    maxRenders = 2;               //Requests rendering at the same time
+	int    maxClients = 32;              //Open connections, including those waiting to render
+	size_t cacheBytes = 256u << 20;      //Budget for cached images
+	size_t maxScenes = 16;               //Parsed scenes kept warm
+	size_t textureBytes = 512u << 20;    //Budget for decoded texture tiles
+	int    maxDiv = 2048;                //Largest image side accepted
+	size_t renderBytes = 512u << 20;     //Budget for the images of the renders in progress
+	std::string textureDir;              //Textures are read from here; empty refuses them
+};
+
+struct ServerStats {
+	int renders = 0;                     //Requests rendered
+	int hits = 0;                        //Answered from a finished render
+	int joins = 0;                       //Answered by waiting for a render in progress
+	int errors = 0;                      //Answered with "ERR ..."
+};
+
+class RenderServer {
+private:
+	struct Result {
+		std::string text;                //Canonical scene and settings, to tell hash collisions
+		std::shared_future<std::string> data;
+		size_t bytes = 0;                //Zero until the render has finished
+		std::list<uint64_t>::iterator lru;
+	};
+	struct CachedScene {
+		std::string text;                //Canonical scene text
+		std::shared_ptr<const Scene> scene;
+		std::list<uint64_t>::iterator lru;
+	};
+
+	ServerSettings settings_;
+	ThreadPool pool_;
+	std::shared_ptr<TextureManager> textures_;
+	int listenFd_ = -1;
+
+	std::mutex mutex_;                   //Guards everything below
+	std::condition_variable slotFree_;
+	std::condition_variable idle_;       //Signalled when the last client leaves
+	int rendering_ = 0;
+	size_t renderingBytes_ = 0;          //Image memory of the renders in progress
+	int clients_ = 0;
+	ServerStats stats_;
+	std::unordered_map<uint64_t, Result> results_;
+	std::list<uint64_t> resultLru_;      //Most recently used first
+	size_t cachedBytes_ = 0;
+	std::unordered_map<uint64_t, CachedScene> scenes_;
+	std::list<uint64_t> sceneLru_;
+
+	void serve(int fd);
+	std::string handle(const std::string& request);
+	std::string render(uint64_t key, const std::string& request, const std::string& sceneText);
+	std::string renderSafely(uint64_t key, const std::string& request, const std::string& sceneText);
+	void evict();
+
+public:
+	explicit RenderServer(const ServerSettings& settings);
+	~RenderServer();
+	RenderServer(const RenderServer&) = delete;
+	RenderServer& operator=(const RenderServer&) = delete;
+
+	bool listen(std::string& error);
+	void run();
+	void stop();
+	int  getPort() const;
+	ServerStats getStats();
+};
+
+uint64_t hashText(const std::string& text, uint64_t seed = 14695981039346656037ull);
+
+#endif //!H_RENDER_SERVER
@@ -0,0 +1,45 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Render server
+*  Renders scene descriptions sent over a local socket.
+*
+*  Usage:  RenderServer.out [-p port] [-t threads] [-j renders] [-c cacheMB]
+*                           [-m renderMB] [-d textureDir]
+*  Scenes may use textures only from textureDir.
+*  Then, for example:
+*      nc -N 127.0.0.1 5363 < room.scene > room.ppm
+-------------------------------------------------------------*/
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "RenderServer.h"
+
+int main(int argc, char *argv[]) {
+	ServerSettings settings;
+	for (int a = 1; a + 1 < argc; a += 2) {
+		int value = atoi(argv[a + 1]);
+		if      (strcmp(argv[a], "-d") == 0) settings.textureDir = argv[a + 1];
+		else if (strcmp(argv[a], "-p") == 0) settings.port = value;
+		else if (strcmp(argv[a], "-t") == 0) settings.threads = value;
+		else if (strcmp(argv[a], "-j") == 0) settings.maxRenders = value;
+		else if (strcmp(argv[a], "-c") == 0) settings.cacheBytes = size_t(value) << 20;
+		else if (strcmp(argv[a], "-m") == 0) settings.renderBytes = size_t(value) << 20;
+		else {
+			std::cerr << "Usage: " << argv[0] << " [-p port] [-t threads] [-j renders] [-c cacheMB]"
+			          << " [-m renderMB] [-d textureDir]" << std::endl;
+			return 1;
+		}
+	}
+
+	RenderServer server(settings);
+	std::string error;
+	if (!server.listen(error)) {
+		std::cerr << error << std::endl;
+		return 1;
+	}
+	std::cerr << "Listening on 127.0.0.1:" << server.getPort() << std::endl;
+	server.run();
+	return 0;
+}
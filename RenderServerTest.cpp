@@ -0,0 +1,154 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Render server test
+*  Starts a RenderServer on a free local port and checks, over
+*  real connections, that a new request is rendered (miss), a
+*  repeated one is answered from the cache (hit), identical
+*  requests sent while the image is rendering share one render
+*  (join), bad requests are answered with "ERR" and not cached,
+*  images over the render memory budget are refused, textures are read only from the texture directory, and a
+*  texture rewritten on disk is not answered from the cache.
+*  Exits with 1 on the first failure.
+-------------------------------------------------------------*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "RenderServer.h"
+
+static const char* SCENE =
+	"light 10 15 5\n"
+	"sphere 0 0 -40 5\n"
+	"color 1 0 0\n"
+	"quad -30 -9 0  30 -9 0  30 -9 -100  -30 -9 -100\n"
+	"checker\n";
+
+static void check(bool ok, const char* what) {
+	printf("%s  %s\n", ok ? "ok  " : "FAIL", what);
+	if (!ok) exit(1);
+}
+
+//Sends 'request', closes the sending side and returns the whole answer
+static std::string roundTrip(int port, const std::string& request) {
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+		close(fd);
+		return "";
+	}
+	send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+	shutdown(fd, SHUT_WR);
+	std::string answer;
+	char buf[4096];
+	for (ssize_t n; (n = recv(fd, buf, sizeof(buf), 0)) > 0; ) answer.append(buf, n);
+	close(fd);
+	return answer;
+}
+
+static bool isImage(const std::string& answer) {
+	return answer.compare(0, 3, "P6\n") == 0;
+}
+
+//Writes a 1 x 1 little-endian PFM texture of colour (r, g, b)
+static void writeTexel(const std::string& path, float r, float g, float b) {
+	FILE* f = fopen(path.c_str(), "wb");
+	fprintf(f, "PF\n1 1\n-1.0\n");
+	float rgb[3] = { r, g, b };
+	fwrite(rgb, sizeof(float), 3, f);
+	fclose(f);
+}
+
+int main() {
+	ServerSettings settings;
+	settings.port = 0;
+	settings.threads = 2;
+	settings.maxRenders = 1;
+	settings.renderBytes = 16u << 20;
+	RenderServer server(settings);
+	std::string error;
+	if (!server.listen(error)) {
+		fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+	std::thread accepting(&RenderServer::run, &server);
+	int port = server.getPort();
+
+	std::string small = std::string(SCENE) + "size 64\nsamples 1\n";
+	std::string first = roundTrip(port, small);
+	check(isImage(first) && server.getStats().renders == 1, "a new request is rendered");
+
+	std::string second = roundTrip(port, "# the same scene\n" + small);
+	check(second == first && server.getStats().renders == 1 && server.getStats().hits == 1,
+	      "a repeated request is answered from the cache");
+
+	//With one render slot, a slow render holds the next request back, so its
+	//twin arrives while it is still waiting and joins it
+	std::string slow = std::string(SCENE) + "size 400\nsamples 3\n";
+	std::string other = std::string(SCENE) + "size 96\nsamples 1\n";
+	std::thread blocker([&] { roundTrip(port, slow); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	std::string a, b;
+	std::thread first2([&] { a = roundTrip(port, other); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	std::thread second2([&] { b = roundTrip(port, other); });
+	first2.join();
+	second2.join();
+	blocker.join();
+	ServerStats stats = server.getStats();
+	check(isImage(a) && a == b && stats.renders == 3 && stats.joins == 1,
+	      "identical requests in flight share one render");
+
+	std::string bad = roundTrip(port, std::string(SCENE) + "depth 1000000\n");
+	check(bad.compare(0, 4, "ERR ") == 0, "an out-of-range depth is rejected");
+	std::string unknown = roundTrip(port, "sphere 0 0 -40 5\nwobble 3\n");
+	std::string again = roundTrip(port, "sphere 0 0 -40 5\nwobble 3\n");
+	stats = server.getStats();
+	check(unknown.compare(0, 4, "ERR ") == 0 && again == unknown && stats.errors == 3 && stats.hits == 1,
+	      "errors are answered and not cached");
+
+	std::string huge = roundTrip(port, std::string(SCENE) + "size 1024\n");
+	check(huge.compare(0, 4, "ERR ") == 0 && server.getStats().renders == 3,
+	      "an image over the render memory budget is refused");
+
+	std::string textured = std::string(SCENE) + "texture ../Mars.bmp\nsize 32\n";
+	check(roundTrip(port, textured).compare(0, 4, "ERR ") == 0,
+	      "textures are refused without a texture directory");
+	server.stop();
+	accepting.join();
+
+	char dir[] = "/tmp/rstestXXXXXX";
+	if (!mkdtemp(dir)) return 1;
+	settings.textureDir = dir;
+	RenderServer texServer(settings);
+	if (!texServer.listen(error)) return 1;
+	std::thread texAccepting(&RenderServer::run, &texServer);
+	port = texServer.getPort();
+	std::string texel = std::string(dir) + "/t.pfm";
+	writeTexel(texel, 1, 0, 0);
+	textured = "light 10 15 5\nsphere 0 0 -40 10\ntexture t.pfm\nsize 32\n";
+	std::string red = roundTrip(port, textured);
+	check(isImage(red) && roundTrip(port, std::string(SCENE) + "texture ../t.pfm\n").compare(0, 4, "ERR ") == 0,
+	      "textures are read only from the texture directory");
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	writeTexel(texel, 0, 0, 1);
+	std::string blue = roundTrip(port, textured);
+	size_t pixels = 32 * 32 * 3;
+	check(isImage(blue) && texServer.getStats().renders == 2
+	      && blue.substr(blue.size() - pixels) != red.substr(red.size() - pixels),
+	      "a rewritten texture is rendered afresh");
+	texServer.stop();
+	texAccepting.join();
+	remove(texel.c_str());
+	rmdir(dir);
+	printf("All render server checks passed\n");
+	return 0;
+}
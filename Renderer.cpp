@@ -0,0 +1,415 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The renderer
+*  trace() and shade() are templated on the set of material
+*  features present in the scene (F_* in Scene.h): branches for
+*  features that no object has are removed at compile time.
+*  tracePixel() is also templated on the AA grid size, and all
+*  are templated on K_FAST_MATH, which swaps the library maths
+*  in shading for the approximations in FastMath.h.  Every
+*  combination is instantiated here and selectKernel() picks
+*  one per frame.
+-------------------------------------------------------------*/
+
+#include "Renderer.h"
+#include "Ray.h"
+#include "PixelCost.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+static const float ambientTerm = 0.2f;
+
+template <unsigned F>
+static glm::vec3 shade(const Scene& scene, Ray& ray, int step, float weight, uint32_t seed,
+                       PixelFeatures* features = nullptr, const TileCandidates* tile = nullptr);
+
+//---The most important function in a ray tracer! ----------------------------------
+//   Computes the colour value obtained by tracing a ray and finding its
+//     closest point of intersection with objects in the scene.
+//   'weight' is the ray's throughput: the most its colour can add to the sample.
+//   'seed' identifies the path (pixel, sample and branches) for Russian roulette.
+//   Primary rays pass their tile's candidate lists as 'tile'.
+//----------------------------------------------------------------------------------
+template <unsigned F>
+static glm::vec3 trace(const Scene& scene, Ray ray, int step, float weight, uint32_t seed,
+                       PixelFeatures* features = nullptr, const TileCandidates* tile = nullptr) {
+    if (tile) ray.closestPt(scene.primitives, tile->primary);
+    else ray.closestPt(scene.primitives);
+    return shade<F>(scene, ray, step, weight, seed, features, tile);
+}
+
+//---Maths that the fast-math kernels approximate -------------------------------------
+template <unsigned F>
+static inline glm::vec3 unit(glm::vec3 v) {
+    if constexpr ((F & K_FAST_MATH) != 0) return fastNormalize(v);
+    else return glm::normalize(v);
+}
+
+template <unsigned F>
+static inline float specularTerm(const Scene& scene, int index, float RV) {
+    if constexpr ((F & K_FAST_MATH) != 0) {
+        int t = scene.powTable[index];
+        if (t >= 0) return scene.powTables[t](RV);
+    }
+    return powf(RV, scene.objects[index]->getShininess());
+}
+
+//---Path termination ---------------------------------------------------------------------
+//   shade() clamps its colour to [0, 1], so a secondary ray of throughput w can change
+//   the sample by at most w.  Rays below scene.cutoff are not traced; with
+//   scene.roulette they are traced with probability w / cutoff instead and scaled up
+//   to match, which keeps the expected colour.  A clamp between the levels of a path
+//   would cut the scaled-up survivors and darken the result, so with roulette shade()
+//   leaves colours unclamped and only the pixel is clamped.  The random numbers are
+//   hashes of the path's seed, which comes from the pixel and sample indices, so each
+//   sample decides on its own and images do not depend on the order pixels are
+//   rendered in.
+//---------------------------------------------------------------------------------------
+static uint32_t hashMix(uint32_t h, uint32_t v) {
+    h ^= v + 0x9E3779B9u + (h << 6) + (h >> 2);
+    h ^= h >> 16; h *= 0x85EBCA6Bu;
+    h ^= h >> 13; h *= 0xC2B2AE35u;
+    return h ^ (h >> 16);
+}
+
+//   Seed of the path that continues through branch 'branch' (0-2) of a hit
+static uint32_t branchSeed(uint32_t seed, unsigned branch) {
+    return hashMix(seed, branch + 3);
+}
+
+//   Returns the coefficient to weight a secondary ray of coefficient k by: k, 0 to skip
+//   the ray, or k / p for a ray that survived roulette with probability p.
+static float branchCoeff(const Scene& scene, float weight, float k, uint32_t seed, unsigned branch) {
+    float w = weight * k;
+    if (w >= scene.cutoff) return k;
+    if (!scene.roulette || w <= 0.0f) return 0.0f;
+    float p = w / scene.cutoff;
+    float u = float(hashMix(seed, branch) >> 8) * (1.0f / 16777216.0f);
+    return (u < p) ? k / p : 0.0f;
+}
+
+//---Finds where a ray that starts inside an object leaves it ------------------------------
+//   Objects that report intervals answer this on their own; anything they contain is
+//   not seen.  Otherwise, or if the ray is not actually inside, the whole scene is
+//   searched as for any other ray.
+//----------------------------------------------------------------------------------
+static void exitObject(const Scene& scene, int index, Ray& ray) {
+    float t = scene.objects[index]->exitDistance(ray.p0, ray.dir);
+    if (t > 0) {
+        if (rayCounters) { rayCounters->rays++; rayCounters->tests++; }
+        ray.index = index;
+        ray.dist = t;
+        ray.hit = ray.p0 + ray.dir * t;
+    }
+    else ray.closestPt(scene.primitives);
+}
+
+//---Surface colour before lighting -----------------------------------------------
+//   The material colour, the texture colour for textured objects, or the
+//     procedural colour for the scene's checkered object.
+//----------------------------------------------------------------------------------
+template <unsigned F>
+static glm::vec3 surfaceColor(const Scene& scene, int index, glm::vec3 hit) {
+    constexpr bool fast = (F & K_FAST_MATH) != 0;
+    if (index == scene.checkeredObject) {
+        int stripeW = 5;
+        int ix = fast ? floorInt(hit.x/stripeW) : int(floor(hit.x/stripeW));
+        int iz = fast ? floorInt(hit.z/stripeW) : int(floor(hit.z/stripeW));
+        return ((ix+iz)&1)
+            ? glm::vec3(0,1,0)
+            : glm::vec3(1,1,0.5f);
+    }
+    if (const Texture* texture = scene.objects[index]->getTexture()) {
+        glm::vec3 N = normal(scene.primitives[index], hit);
+        float u = 0.5f + (fast ? fastAtan2(N.z, N.x) : atan2(N.z, N.x))/(2.0f*M_PI);
+        float v = 0.5f - (fast ? fastAsin(N.y) : asin(N.y))/M_PI;
+        return texture->getColorAt(u,v);
+    }
+    return scene.objects[index]->getColor();
+}
+
+//---Computes the colour at a ray's closest point of intersection -----------------
+//   The ray's hit, index and dist must already be set (by closestPt or by the
+//     visibility pass).
+//   If 'features' is given, the normal, albedo, depth and position of the hit are
+//     stored there for the denoiser and for reprojection.
+//   If 'tile' is given, shadow rays test only its per-light candidates.  Only objects
+//     between the hit and the light cast shadows.
+//----------------------------------------------------------------------------------
+template <unsigned F>
+static glm::vec3 shade(const Scene& scene, Ray& ray, int step, float weight, uint32_t seed,
+                       PixelFeatures* features, const TileCandidates* tile) {
+    if (rayCounters && unsigned(step) > rayCounters->depth) rayCounters->depth = step;
+    if (ray.index < 0) return glm::vec3(0.0f);
+
+    SceneObject* obj = scene.objects[ray.index];
+    glm::vec3  hit   = ray.hit;
+
+    glm::vec3 baseCol = surfaceColor<F>(scene, ray.index, hit);
+    glm::vec3 N = normal(scene.primitives[ray.index], hit);
+    glm::vec3 V = unit<F>(-ray.dir);
+
+    if (features) {
+        features->normal = N;
+        features->albedo = baseCol;
+        features->depth  = ray.dist;
+        features->position = hit;
+        features->object = ray.index;
+    }
+
+    glm::vec3 color = ambientTerm * baseCol;
+
+    float lightScale = 1.0f / float(scene.lights.size());
+    for (size_t l = 0; l < scene.lights.size(); l++) {
+        const glm::vec3& Lpos = scene.lights[l];
+        glm::vec3 L     = unit<F>(Lpos - hit);
+        Ray shadow(hit, L);
+        if (tile && !tile->shadow.empty()) shadow.closestPt(scene.primitives, tile->shadow[l]);
+        else shadow.closestPt(scene.primitives);
+        if (shadow.index >= 0 && shadow.dist > glm::length(Lpos - shadow.p0)) shadow.index = -1;
+
+        float NdotL     = glm::max(glm::dot(N, L), 0.0f);
+        glm::vec3 diff  = NdotL * baseCol;
+        glm::vec3 spec(0.0f);
+        if ((F & F_SPECULAR) && obj->isSpecular()) {
+            glm::vec3 R    = glm::reflect(-L, N);
+            float     RV   = glm::max(glm::dot(R, V), 0.0f);
+            spec           = glm::vec3(specularTerm<F>(scene, ray.index, RV));
+        }
+
+        glm::vec3 contrib(0.0f);
+        if (shadow.index < 0) {
+            contrib = diff + spec;
+        }
+        else {
+            SceneObject* blocker = scene.objects[shadow.index];
+            float factor = 0.0f;
+            if (blocker->isTransparent()) {
+                factor = blocker->getTransparencyCoeff() / 1.5;
+            }
+            else if (blocker->isRefractive()) {
+                factor = blocker->getRefractionCoeff() / 1.5;
+            }
+            contrib = factor * (diff + spec);
+        }
+        color += lightScale * contrib;
+    }
+
+    float kr;
+    if ((F & F_REFLECT) && obj->isReflective() && step < scene.maxDepth
+        && (kr = branchCoeff(scene, weight, obj->getReflectionCoeff(), seed, 0)) > 0.0f) {
+        glm::vec3 R = glm::reflect(ray.dir, N);
+        Ray rray(hit, R); rray.closestPt(scene.primitives);
+        if (rray.index > -1)
+            color += kr * shade<F>(scene, rray, step+1, weight * kr, branchSeed(seed, 0));
+    }
+    if ((F & F_REFRACT) && obj->isRefractive() && step < scene.maxDepth
+        && (kr = branchCoeff(scene, weight, obj->getRefractionCoeff(), seed, 1)) > 0.0f) {
+        float eta = obj->getRefractiveIndex();
+        glm::vec3 nrm = N;
+        float n1=1, n2=eta;
+
+        if (glm::dot(ray.dir,nrm)>0){ nrm=-nrm; std::swap(n1,n2); }
+
+        glm::vec3 rd = unit<F>(glm::refract(ray.dir,nrm,n1/n2));
+        Ray through(hit, rd); exitObject(scene, ray.index, through);
+
+        if (through.index > -1) {
+            glm::vec3 exitPt = through.hit;
+            glm::vec3 N2     = normal(scene.primitives[through.index], exitPt);
+            if (glm::dot(rd,N2)>0) N2=-N2;
+            glm::vec3 rd2 = unit<F>(glm::refract(rd,N2,n2/n1));
+            Ray exitRay(exitPt, rd2); exitRay.closestPt(scene.primitives);
+            if (exitRay.index > -1)
+                color += kr * shade<F>(scene, exitRay, step+1, weight * kr, branchSeed(seed, 1));
+        }
+    }
+    if ((F & F_TRANSPARENT) && obj->isTransparent() && step < scene.maxDepth
+        && (kr = branchCoeff(scene, weight, obj->getTransparencyCoeff(), seed, 2)) > 0.0f) {
+        Ray t1(hit, ray.dir); exitObject(scene, ray.index, t1);
+        if (t1.index>-1) {
+            Ray t2(t1.hit, ray.dir);
+            color += kr * trace<F>(scene, t2, step+1, weight * kr, branchSeed(seed, 2));
+        }
+    }
+
+    if (scene.roulette) return color;
+    return glm::clamp(color, glm::vec3(0.0f), glm::vec3(1.0f));
+}
+
+
+//---Traces one cell of the image -----------------------------------------------------
+//   The cell is traced with an n x n grid of samples.  The shading features of all
+//   samples are averaged so the denoiser sees the same footprint as the colour; the
+//   hit position and object of the first sample are kept for reprojection.
+//   If ctx.vis is set, the first hits are taken from it instead of being traced.
+//   N is the AA grid size fixed at compile time, or 0 to use ctx.grid.
+//---------------------------------------------------------------------------------------
+template <unsigned F, int N>
+static void tracePixel(const RenderContext& ctx, int i, int j) {
+    const Scene& scene = *ctx.scene;
+    const int grid = (N > 0) ? N : ctx.grid;
+    const float weight = 1.0f / float(grid * grid);
+
+    glm::vec3 accum(0.0f);
+    PixelFeatures f;
+    for (int sx = 0; sx < grid; ++sx) {
+        for (int sy = 0; sy < grid; ++sy) {
+            Ray ray(ctx.camera->eye, ctx.camera->sampleDir(i, j, sx, sy, ctx.div, grid));
+            uint32_t seed = hashMix(hashMix(uint32_t(j), uint32_t(i)), uint32_t(sx * grid + sy));
+            PixelFeatures sf;
+            if (ctx.vis) {
+                int q = ctx.vis->index(i, j, sx, sy, grid);
+                ray.index = ctx.vis->object[q];
+                ray.dist = ctx.vis->depth[q];
+                ray.hit = ray.p0 + ray.dir * ray.dist;
+                accum += shade<F>(scene, ray, 1, 1.0f, seed, &sf, ctx.cull);
+            }
+            else {
+                accum += trace<F>(scene, ray, 1, 1.0f, seed, &sf, ctx.cull);
+            }
+            f.normal += weight * sf.normal;
+            f.albedo += weight * sf.albedo;
+            f.depth  += weight * sf.depth;
+            if (sx == 0 && sy == 0) {
+                f.position = sf.position;
+                f.object = sf.object;
+            }
+        }
+    }
+    int p = (j - ctx.y0) * ctx.out->width + (i - ctx.x0);
+    ctx.out->color[p] = glm::clamp(accum * weight, glm::vec3(0.0f), glm::vec3(1.0f));
+    ctx.out->features[p] = f;
+}
+
+//---Kernel selection --------------------------------------------------------------------
+//   Every combination of scene features, fast math and AA grid sizes 1-3 is
+//   instantiated at compile time; the matching kernel is picked once per frame.
+//---------------------------------------------------------------------------------------
+template <unsigned F>
+static PixelKernel selectGrid(int grid) {
+    switch (grid) {
+        case 1:  return tracePixel<F, 1>;
+        case 2:  return tracePixel<F, 2>;
+        case 3:  return tracePixel<F, 3>;
+        default: return tracePixel<F, 0>;
+    }
+}
+
+template <unsigned F = 0>
+static PixelKernel selectFeatures(unsigned features, int grid) {
+    if constexpr (F > (F_ALL | K_FAST_MATH)) {
+        return nullptr;
+    }
+    else {
+        if (features == F) return selectGrid<F>(grid);
+        return selectFeatures<F + 1>(features, grid);
+    }
+}
+
+PixelKernel selectKernel(unsigned features, int grid, bool fastMath) {
+    return selectFeatures((features & F_ALL) | (fastMath ? K_FAST_MATH : 0), grid);
+}
+
+
+//---Bounds of the primary hits of a region -----------------------------------------------
+//   Taken from the visibility buffer if there is one, otherwise from the boxes of the
+//   objects the region may see.  Returns false if they cannot be bounded.
+//---------------------------------------------------------------------------------------
+static bool primaryHitBounds(const RenderContext& ctx, const std::vector<int>& candidates,
+                             glm::vec3& lo, glm::vec3& hi)
+{
+    lo = glm::vec3(1.e+30f);
+    hi = glm::vec3(-1.e+30f);
+    if (ctx.vis) {
+        const VisibilityBuffer& vis = *ctx.vis;
+        for (int t = 0; t < vis.height; t++) {
+            for (int s = 0; s < vis.width; s++) {
+                int q = t * vis.width + s;
+                if (vis.object[q] < 0) continue;
+                int x = vis.x0 + s, y = vis.y0 + t;
+                Ray ray(ctx.camera->eye, ctx.camera->sampleDir(x / ctx.grid, y / ctx.grid,
+                                                               x % ctx.grid, y % ctx.grid, ctx.div, ctx.grid));
+                glm::vec3 p = ray.p0 + ray.dir * vis.depth[q];
+                lo = glm::min(lo, p);
+                hi = glm::max(hi, p);
+            }
+        }
+        return true;
+    }
+    for (int k : candidates) {
+        glm::vec3 blo, bhi;
+        if (!ctx.scene->objects[k]->getBounds(blo, bhi)) return false;
+        lo = glm::min(lo, blo);
+        hi = glm::max(hi, bhi);
+    }
+    return true;
+}
+
+//---Renders cells [i0, i1) x [j0, j1) into ctx.out -------------------------------------
+//   With rasterVisibility set, primary hits for the region are found in object order
+//   first and tracing starts at the first bounce.  With tileCulling set, primary rays
+//   and the shadow rays from primary hits test only the region's candidate objects
+//   (Culling.h); the lengths of its lists are added to 'stats' if given.
+//---------------------------------------------------------------------------------------
+void renderRegion(const RenderContext& ctx, int i0, int j0, int i1, int j1,
+                  bool rasterVisibility, bool tileCulling, CullStats* stats)
+{
+    RenderContext rc = ctx;
+    VisibilityBuffer vis;
+    if (rasterVisibility) {
+        rasterizeVisibility(*ctx.scene, *ctx.camera, ctx.div, ctx.grid, vis, i0, j0, i1, j1);
+        rc.vis = &vis;
+    }
+
+    TileCandidates tile;
+    if (tileCulling) {
+        primaryCandidates(*ctx.scene, *ctx.camera, ctx.div, ctx.grid, i0, j0, i1, j1, tile.primary);
+        glm::vec3 lo, hi;
+        if (primaryHitBounds(rc, tile.primary, lo, hi))
+            shadowCandidates(*ctx.scene, lo, hi, tile.shadow);
+        rc.cull = &tile;
+        if (stats) {
+            stats->objects = (int)ctx.scene->objects.size();
+            stats->add(tile);
+        }
+    }
+
+    if (ctx.fastMath) ctx.scene->prepareFastMath();
+    PixelKernel kernel = selectKernel(ctx.scene->features, ctx.grid, ctx.fastMath);
+    for (int j = j0; j < j1; ++j)
+        for (int i = i0; i < i1; ++i)
+            kernel(rc, i, j);
+}
+
+
+//---Renders cells [i0, i1) x [j0, j1) into ctx.out, measuring each cell -----------------
+//   Every cell is traced on its own, without the visibility pass, so that all of its
+//   cost is charged to it.  'cost' has the same layout as ctx.out.
+//---------------------------------------------------------------------------------------
+void profileRegion(const RenderContext& ctx, int i0, int j0, int i1, int j1, CostBuffer& cost) {
+    if (ctx.fastMath) ctx.scene->prepareFastMath();
+    PixelKernel kernel = selectKernel(ctx.scene->features, ctx.grid, ctx.fastMath);
+    RayCounters counters;
+    RayCounters* saved = rayCounters;
+    rayCounters = &counters;
+    for (int j = j0; j < j1; ++j) {
+        for (int i = i0; i < i1; ++i) {
+            counters = RayCounters();
+            auto start = std::chrono::steady_clock::now();
+            kernel(ctx, i, j);
+            auto end = std::chrono::steady_clock::now();
+
+            int p = (j - ctx.y0) * cost.width + (i - ctx.x0);
+            cost.time[p]  = std::chrono::duration<float, std::nano>(end - start).count();
+            cost.rays[p]  = float(counters.rays);
+            cost.tests[p] = float(counters.tests);
+            cost.steps[p] = float(counters.steps);
+            cost.depth[p] = float(counters.depth);
+        }
+    }
+    rayCounters = saved;
+}
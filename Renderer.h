@@ -0,0 +1,57 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The renderer
+*  Ray tracing kernels that turn a Scene seen through a Camera
+*  into a GBuffer.  They use no global state (the profiling
+*  counters are per thread), so any number of renders can run
+*  at once on different threads, as long as each writes to its
+*  own region of the output.
+-------------------------------------------------------------*/
+
+#ifndef H_RENDERER
+#define H_RENDERER
+
+#include "Scene.h"
+#include "Camera.h"
+#include "Denoiser.h"
+#include "Visibility.h"
+#include "PixelCost.h"
+#include "Culling.h"
+
+//Kernel option beyond the F_* scene features: shade with the FastMath.h approximations
+constexpr unsigned K_FAST_MATH = 16;
+
+#ifdef RT_FAST_MATH
+constexpr bool FAST_MATH_DEFAULT = true;
+#else
+constexpr bool FAST_MATH_DEFAULT = false;
+#endif
+
+/**
+* Everything one pixel kernel call needs.  'out' may cover only part of the
+* image: cell (i, j) is written to out at (i - x0, j - y0).
+*/
+struct RenderContext {
+	const Scene*  scene;
+	const Camera* camera;
+	int  div;                              //The image is div x div cells
+	int  grid;                             //Each cell gets grid x grid samples
+	GBuffer* out;
+	int  x0 = 0, y0 = 0;                   //Cell covered by out(0, 0)
+	const VisibilityBuffer* vis = nullptr; //Primary hits, if already known
+	const TileCandidates* cull = nullptr;  //Candidate objects for the region, if known
+	bool fastMath = FAST_MATH_DEFAULT;     //Kernel used by renderRegion/profileRegion
+};
+
+typedef void (*PixelKernel)(const RenderContext& ctx, int i, int j);
+
+//A fast-math kernel needs Scene::prepareFastMath() first; renderRegion/profileRegion call it
+PixelKernel selectKernel(unsigned features, int grid, bool fastMath = FAST_MATH_DEFAULT);
+
+void renderRegion(const RenderContext& ctx, int i0, int j0, int i1, int j1,
+                  bool rasterVisibility, bool tileCulling = true, CullStats* stats = nullptr);
+
+void profileRegion(const RenderContext& ctx, int i0, int j0, int i1, int j1, CostBuffer& cost);
+
+#endif //!H_RENDERER
@@ -0,0 +1,49 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Temporal reprojection
+-------------------------------------------------------------*/
+
+#include "Reprojection.h"
+#include <cmath>
+
+/**
+* Splats 'prev' into 'cur' (already sized) as seen from 'cam'.  viewDependent
+* is indexed by object and marks surfaces whose colour changes with the view
+* direction (mirrors, glass); those pixels are never carried over.
+* valid[p] is set for each pixel of 'cur' that received data.
+* Returns the number of valid pixels.
+*/
+int reproject(const GBuffer& prev, const Camera& cam,
+              const std::vector<char>& viewDependent,
+              GBuffer& cur, std::vector<char>& valid)
+{
+	const int w = cur.width, h = cur.height;
+	const float cellX = (cam.xmax - cam.xmin) / w;
+	const float cellY = (cam.ymax - cam.ymin) / h;
+
+	valid.assign(w * h, 0);
+	std::vector<float> zbuf(w * h, 1.e+30f);
+	int count = 0;
+
+	for (size_t p = 0; p < prev.features.size(); p++) {
+		const PixelFeatures& f = prev.features[p];
+		if (f.object < 0 || viewDependent[f.object]) continue;
+
+		float x, y, depth;
+		if (!cam.project(f.position, x, y, depth)) continue;
+		int i = (int)std::floor((x - cam.xmin) / cellX);
+		int j = (int)std::floor((y - cam.ymin) / cellY);
+		if (i < 0 || i >= w || j < 0 || j >= h) continue;
+
+		int q = j * w + i;
+		if (depth >= zbuf[q]) continue;
+		if (!valid[q]) count++;
+		zbuf[q] = depth;
+		valid[q] = 1;
+		cur.color[q] = prev.color[p];
+		cur.features[q] = f;
+		cur.features[q].depth = glm::length(f.position - cam.eye);
+	}
+	return count;
+}
@@ -0,0 +1,23 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Temporal reprojection
+*  Reuses the previous frame after a camera move: every pixel's
+*  primary hit point is projected into the new view and written
+*  to the cell it lands in, keeping the nearest one.  Cells that
+*  receive nothing (disocclusions, newly visible borders) and
+*  cells showing view-dependent surfaces must be traced again.
+-------------------------------------------------------------*/
+
+#ifndef H_REPROJECTION
+#define H_REPROJECTION
+
+#include <vector>
+#include "Camera.h"
+#include "Denoiser.h"
+
+int reproject(const GBuffer& prev, const Camera& cam,
+              const std::vector<char>& viewDependent,
+              GBuffer& cur, std::vector<char>& valid);
+
+#endif //!H_REPROJECTION
@@ -0,0 +1,69 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Signed distance functions
+*  See https://iquilezles.org/articles/distfunctions/
+-------------------------------------------------------------*/
+
+#include "SDF.h"
+#include <algorithm>
+#include <cmath>
+
+SDF sdSphere(glm::vec3 center, float radius) {
+	return [=](const glm::vec3& p) {
+		return glm::length(p - center) - radius;
+	};
+}
+
+SDF sdBox(glm::vec3 center, glm::vec3 halfSize) {
+	return [=](const glm::vec3& p) {
+		glm::vec3 q = glm::abs(p - center) - halfSize;
+		float outside = glm::length(glm::max(q, glm::vec3(0.0f)));
+		float inside = std::min(std::max(q.x, std::max(q.y, q.z)), 0.0f);
+		return outside + inside;
+	};
+}
+
+SDF sdTorus(glm::vec3 center, float majorR, float minorR) {
+	return [=](const glm::vec3& p) {
+		glm::vec3 q = p - center;
+		glm::vec2 v(glm::length(glm::vec2(q.x, q.y)) - majorR, q.z);
+		return glm::length(v) - minorR;
+	};
+}
+
+SDF opUnion(SDF a, SDF b) {
+	return [=](const glm::vec3& p) {
+		return std::min(a(p), b(p));
+	};
+}
+
+SDF opIntersect(SDF a, SDF b) {
+	return [=](const glm::vec3& p) {
+		return std::max(a(p), b(p));
+	};
+}
+
+SDF opSubtract(SDF a, SDF b) {
+	return [=](const glm::vec3& p) {
+		return std::max(a(p), -b(p));
+	};
+}
+
+/**
+* Polynomial smooth minimum: blends the two surfaces where they are within k.
+*/
+SDF opSmoothUnion(SDF a, SDF b, float k) {
+	return [=](const glm::vec3& p) {
+		float da = a(p), db = b(p);
+		float h = glm::clamp(0.5f + 0.5f * (db - da) / k, 0.0f, 1.0f);
+		return glm::mix(db, da, h) - k * h * (1.0f - h);
+	};
+}
+
+SDF opDisplace(SDF a, float amplitude, float frequency) {
+	return [=](const glm::vec3& p) {
+		glm::vec3 s = glm::sin(frequency * p);
+		return a(p) + amplitude * s.x * s.y * s.z;
+	};
+}
@@ -0,0 +1,35 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Signed distance functions
+*  Building blocks for implicit shapes rendered by SDFObject.
+*  Primitives return a distance function; the op* functions
+*  combine distance functions into new ones, so shapes can be
+*  composed freely, e.g.
+*      opSmoothUnion(sdSphere(c, 1), sdBox(c, glm::vec3(1)), 0.3f)
+-------------------------------------------------------------*/
+
+#ifndef H_SDF
+#define H_SDF
+
+#include <glm/glm.hpp>
+#include <functional>
+
+typedef std::function<float(const glm::vec3&)> SDF;
+
+//Primitives
+SDF sdSphere(glm::vec3 center, float radius);
+SDF sdBox(glm::vec3 center, glm::vec3 halfSize);
+SDF sdTorus(glm::vec3 center, float majorR, float minorR);   //Ring lies in the XY plane
+
+//CSG
+SDF opUnion(SDF a, SDF b);
+SDF opIntersect(SDF a, SDF b);
+SDF opSubtract(SDF a, SDF b);                 //a with b removed
+SDF opSmoothUnion(SDF a, SDF b, float k);     //k is the blend radius
+
+//Deformations.  These are not exact distances: use SDFObject::setStepScale
+//to keep the march conservative (1 / (1 + amplitude * frequency * sqrt(3)) is safe).
+SDF opDisplace(SDF a, float amplitude, float frequency);
+
+#endif //!H_SDF
@@ -0,0 +1,109 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The SDFObject class
+*  Marching uses over-relaxed sphere tracing (Keinert et al. 2014):
+*  steps are stretched by OMEGA, and if two consecutive unbounding
+*  spheres stop overlapping the step is undone and the march falls
+*  back to plain sphere tracing.  The hit tolerance grows with the
+*  distance travelled, so far surfaces need fewer steps.
+-------------------------------------------------------------*/
+
+#include "SDFObject.h"
+#include "PixelCost.h"
+#include <algorithm>
+#include <cmath>
+
+static constexpr float OMEGA = 1.6f;   //Over-relaxation factor
+static constexpr float NORMAL_EPS = 1e-3f;
+
+/**
+* Clips the ray to an axis-aligned box.  Returns false if the ray misses it.
+*/
+static bool clipToBox(glm::vec3 p0, glm::vec3 dir, glm::vec3 lo, glm::vec3 hi,
+                      float& tNear, float& tFar)
+{
+	tNear = 0.0f;
+	tFar = 1.e+6f;
+	for (int a = 0; a < 3; a++) {
+		float inv = 1.0f / dir[a];
+		float t0 = (lo[a] - p0[a]) * inv;
+		float t1 = (hi[a] - p0[a]) * inv;
+		if (t0 > t1) std::swap(t0, t1);
+		tNear = std::max(tNear, t0);
+		tFar = std::min(tFar, t1);
+		if (tNear > tFar) return false;
+	}
+	return true;
+}
+
+float SDFObject::intersect(glm::vec3 p0, glm::vec3 dir) {
+	float t, tEnd;
+	if (!clipToBox(p0, dir, boxMin_, boxMax_, t, tEnd)) return -1.0f;
+	tEnd = std::min(tEnd, maxDist_);
+
+	float omega = OMEGA;
+	float prevRadius = 0.0f;
+	float stepLen = 0.0f;
+	float hit = -1.0f;
+	int i = 0;
+	for (; i < maxSteps_ && t <= tEnd; ++i) {
+		float radius = stepScale_ * sdf_(p0 + dir * t);
+
+		bool overshoot = omega > 1.0f && (radius + prevRadius) < stepLen;
+		if (overshoot) {
+			//Spheres no longer overlap: undo the stretched step and relax normally
+			t -= stepLen;
+			stepLen = stepLen / omega;
+			omega = 1.0f;
+			t += stepLen;
+			prevRadius = 0.0f;
+			continue;
+		}
+		if (radius < std::max(minEps_, surfEps_ * t)) {
+			hit = t;
+			break;
+		}
+		stepLen = radius * omega;
+		prevRadius = radius;
+		t += stepLen;
+	}
+
+	if (rayCounters) rayCounters->steps += i;   //Profiling
+	return hit;
+}
+
+/**
+* Gradient of the distance function using the tetrahedron technique
+* (four evaluations instead of six).
+*/
+glm::vec3 SDFObject::normal(glm::vec3 p) {
+	const glm::vec3 k0(1, -1, -1), k1(-1, -1, 1), k2(-1, 1, -1), k3(1, 1, 1);
+	glm::vec3 n = k0 * sdf_(p + NORMAL_EPS * k0) + k1 * sdf_(p + NORMAL_EPS * k1)
+	            + k2 * sdf_(p + NORMAL_EPS * k2) + k3 * sdf_(p + NORMAL_EPS * k3);
+	return glm::normalize(n);
+}
+
+bool SDFObject::getBounds(glm::vec3& lo, glm::vec3& hi) {
+	lo = boxMin_;
+	hi = boxMax_;
+	return true;
+}
+
+float SDFObject::distance(glm::vec3 p) {
+	return sdf_(p);
+}
+
+void SDFObject::setMarchLimits(int maxSteps, float maxDist) {
+	maxSteps_ = maxSteps;
+	maxDist_ = maxDist;
+}
+
+void SDFObject::setTolerance(float relEps, float minEps) {
+	surfEps_ = relEps;
+	minEps_ = minEps;
+}
+
+void SDFObject::setStepScale(float scale) {
+	stepScale_ = scale;
+}
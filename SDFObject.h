@@ -0,0 +1,44 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The SDFObject class
+*  A scene object whose surface is the zero set of a signed
+*  distance function.  intersect() sphere-traces the function,
+*  and normal() takes its gradient from four evaluations at the
+*  corners of a tetrahedron.  March steps are counted in the
+*  calling thread's rayCounters (PixelCost.h) when it is set.
+-------------------------------------------------------------*/
+
+#ifndef H_SDF_OBJECT
+#define H_SDF_OBJECT
+
+#include <glm/glm.hpp>
+#include "SceneObject.h"
+#include "SDF.h"
+
+class SDFObject : public SceneObject {
+protected:
+	SDF       sdf_;
+	glm::vec3 boxMin_;            //Bounding box of the surface; marching is clipped to it
+	glm::vec3 boxMax_;
+	int       maxSteps_ = 100;    //Step budget per ray
+	float     maxDist_  = 100.0f; //Give up beyond this distance along the ray
+	float     surfEps_  = 2e-5f;  //Hit tolerance per unit distance along the ray
+	float     minEps_   = 1e-4f;  //Lower bound on the hit tolerance
+	float     stepScale_ = 1.0f;  //< 1 for distance functions that overestimate
+
+public:
+	SDFObject(SDF sdf, glm::vec3 boxMin, glm::vec3 boxMax)
+	  : sdf_(sdf), boxMin_(boxMin), boxMax_(boxMax) {}
+
+	float       intersect(glm::vec3 p0, glm::vec3 dir) override;
+	glm::vec3   normal   (glm::vec3 p)       override;
+	bool        getBounds(glm::vec3& lo, glm::vec3& hi) override;
+
+	float distance(glm::vec3 p);
+	void  setMarchLimits(int maxSteps, float maxDist);
+	void  setTolerance(float relEps, float minEps);
+	void  setStepScale(float scale);
+};
+
+#endif //!H_SDF_OBJECT
@@ -0,0 +1,58 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Scene class
+-------------------------------------------------------------*/
+
+#include "Scene.h"
+
+Scene::~Scene() {
+	for (SceneObject* obj : objects) delete obj;
+}
+
+/**
+* Adds an object to the scene, which takes ownership of it.
+* Returns the object's index.
+*/
+int Scene::add(SceneObject* obj) {
+	objects.push_back(obj);
+	return (int)objects.size() - 1;
+}
+
+void Scene::addLight(glm::vec3 pos) {
+	lights.push_back(pos);
+}
+
+/**
+* Builds the derived data used by the renderer.  Must be called again if
+* objects or their materials change.
+*/
+void Scene::finalize() {
+	primitives = makePrimitives(objects);
+	features = 0;
+	for (SceneObject* obj : objects) {
+		if (obj->isReflective())  features |= F_REFLECT;
+		if (obj->isRefractive())  features |= F_REFRACT;
+		if (obj->isTransparent()) features |= F_TRANSPARENT;
+		if (obj->isSpecular())    features |= F_SPECULAR;
+	}
+}
+
+/**
+* Builds the tables used by fast-math shading, once; renders call this
+* before using a fast-math kernel.  Safe to call from concurrent renders;
+* the objects must not change afterwards.
+*/
+void Scene::prepareFastMath() const {
+	std::call_once(fastMathOnce_, [this] {
+		powTable.assign(objects.size(), -1);
+		for (size_t k = 0; k < objects.size(); k++) {
+			float shininess = objects[k]->getShininess();
+			if (!objects[k]->isSpecular() || !PowTable::fits(shininess)) continue;
+			size_t t = 0;
+			while (t < powTables.size() && powTables[t].getExponent() != shininess) t++;
+			if (t == powTables.size()) powTables.emplace_back(shininess);
+			powTable[k] = (int)t;
+		}
+	});
+}
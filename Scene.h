@@ -0,0 +1,57 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Scene class
+*  Everything a render needs to know about the world: objects,
+*  lights and the manager its textures are loaded through.  A
+*  scene owns its objects.  Call
+*  finalize() after the last object is added; after that the
+*  scene is read-only and may be shared by concurrent renders.
+-------------------------------------------------------------*/
+
+#ifndef H_SCENE
+#define H_SCENE
+
+#include <glm/glm.hpp>
+#include <mutex>
+#include <vector>
+#include "SceneObject.h"
+#include "Primitive.h"
+#include "TextureManager.h"
+#include "FastMath.h"
+
+//Material features a scene may contain; the render kernels are specialised on these
+constexpr unsigned F_REFLECT = 1, F_REFRACT = 2, F_TRANSPARENT = 4, F_SPECULAR = 8;
+constexpr unsigned F_ALL = F_REFLECT | F_REFRACT | F_TRANSPARENT | F_SPECULAR;
+
+class Scene {
+public:
+	std::vector<SceneObject*> objects;
+	std::vector<Primitive> primitives;   //objects, for statically dispatched intersection
+	std::vector<glm::vec3> lights;       //Point light positions
+	std::shared_ptr<TextureManager> textures = std::make_shared<TextureManager>();   //May be shared by scenes
+	int checkeredObject = -1;            //Object coloured with a checkerboard in the xz plane
+	int maxDepth = 5;                    //Most rays in one path; the primary ray is the first
+	float cutoff = 1.0f / 512.0f;        //Secondary rays of lower throughput are not traced
+	bool roulette = false;               //Trace them with probability throughput / cutoff instead
+	unsigned features = 0;               //Union of the F_* flags of all objects
+
+	//Fast-math specular tables, built by the first prepareFastMath() call
+	mutable std::vector<PowTable> powTables;   //One per distinct shininess that fits a table
+	mutable std::vector<int> powTable;         //Per object: index into powTables, -1 to use powf
+
+	Scene() {}
+	~Scene();
+	Scene(const Scene&) = delete;
+	Scene& operator=(const Scene&) = delete;
+
+	int  add(SceneObject* obj);
+	void addLight(glm::vec3 pos);
+	void finalize();
+	void prepareFastMath() const;
+
+private:
+	mutable std::once_flag fastMathOnce_;
+};
+
+#endif //!H_SCENE
@@ -0,0 +1,154 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Scaling benchmark
+*  Renders generated scenes (SceneGenerator.h) while varying
+*  one parameter and prints a CSV line per scene with the
+*  render time and the rays traced per second, for plotting
+*  how a change affects each scaling curve.  The rasterized
+*  visibility pass is off, so primary rays are traced, and
+*  counted, like every other ray; times are therefore those of
+*  ray-traced primary visibility.
+*
+*  Sweeps:
+*      objects   4 to 512 objects, 2 lights
+*      lights    1 to 16 lights, 64 objects
+*      depth     depth 1 to 8, 64 objects, half of them mirrors
+*      mix       0% to 100% reflective (then refractive,
+*                transparent) objects, 64 objects
+*      all       each of the above
+*
+*  Usage:  SceneBench.out [sweep] [-s size] [-t threads] [-r seed] [-g 0|1]
+-------------------------------------------------------------*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "SceneGenerator.h"
+#include "SceneParser.h"
+#include "PixelCost.h"
+
+struct BenchOptions {
+	int div = 256;
+	int threads = 0;
+	GeneratorSettings base;
+};
+
+//Renders the scene of 'gen' on 'threads' threads of its own, so that every
+//thread's rays can be counted through rayCounters
+static void bench(const char* sweep, double value, const GeneratorSettings& gen, const BenchOptions& opt) {
+	std::shared_ptr<Scene> scene = std::make_shared<Scene>();
+	RenderSettings settings;
+	std::string error;
+	if (!parseDescription(generateScene(gen), scene.get(), &settings, nullptr, error)) {
+		fprintf(stderr, "%s\n", error.c_str());
+		exit(1);
+	}
+	settings.div = opt.div;
+	settings.rasterVisibility = false;   //The pass resolves primary hits without counted rays
+
+	GBuffer image;
+	image.resize(settings.div, settings.div);
+	RenderContext ctx{ scene.get(), &settings.camera, settings.div, settings.grid, &image };
+	ctx.fastMath = settings.fastMath;
+	int ts = settings.tileSize, side = (settings.div + ts - 1) / ts;
+	int threads = opt.threads > 0 ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+
+	std::atomic<int> nextTile{0};
+	std::vector<RayCounters> counts(threads);
+	std::vector<std::thread> workers;
+	auto start = std::chrono::steady_clock::now();
+	for (int t = 0; t < threads; t++) {
+		workers.emplace_back([&, t] {
+			rayCounters = &counts[t];
+			for (int k; (k = nextTile++) < side * side; ) {
+				int i0 = (k % side) * ts, j0 = (k / side) * ts;
+				renderRegion(ctx, i0, j0, std::min(i0 + ts, settings.div), std::min(j0 + ts, settings.div),
+				             settings.rasterVisibility, settings.tileCulling);
+			}
+			rayCounters = nullptr;
+		});
+	}
+	for (std::thread& w : workers) w.join();
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	unsigned long long rays = 0, tests = 0;
+	for (const RayCounters& c : counts) {
+		rays += c.rays;
+		tests += c.tests;
+	}
+	printf("%s,%g,%d,%d,%d,%.2f,%.2f,%.2f,%.1f,%llu,%.3f,%.2f\n", sweep, value, gen.objects, gen.lights,
+	       gen.depth, gen.reflective, gen.refractive, gen.transparent, ms, rays,
+	       rays / (ms * 1000.0), rays ? double(tests) / rays : 0.0);
+	fflush(stdout);
+}
+
+static void sweepObjects(const BenchOptions& opt) {
+	for (int n = 4; n <= 512; n *= 2) {
+		GeneratorSettings gen = opt.base;
+		gen.objects = n;
+		bench("objects", n, gen, opt);
+	}
+}
+
+static void sweepLights(const BenchOptions& opt) {
+	for (int l = 1; l <= 16; l *= 2) {
+		GeneratorSettings gen = opt.base;
+		gen.objects = 64;
+		gen.lights = l;
+		bench("lights", l, gen, opt);
+	}
+}
+
+static void sweepDepth(const BenchOptions& opt) {
+	for (int d = 1; d <= 8; d++) {
+		GeneratorSettings gen = opt.base;
+		gen.objects = 64;
+		gen.depth = d;
+		gen.reflective = 0.5f;
+		bench("depth", d, gen, opt);
+	}
+}
+
+static void sweepMix(const BenchOptions& opt) {
+	const char* names[3] = { "reflective", "refractive", "transparent" };
+	for (int m = 0; m < 3; m++) {
+		for (int pct = 0; pct <= 100; pct += 25) {
+			GeneratorSettings gen = opt.base;
+			gen.objects = 64;
+			float* fraction[3] = { &gen.reflective, &gen.refractive, &gen.transparent };
+			for (int k = 0; k < 3; k++) *fraction[k] = (k == m) ? pct / 100.0f : 0.0f;
+			bench(names[m], pct, gen, opt);
+		}
+	}
+}
+
+int main(int argc, char *argv[]) {
+	BenchOptions opt;
+	std::string sweep = "objects";
+	int a = 1;
+	if (a < argc && argv[a][0] != '-') sweep = argv[a++];
+	for (; a + 1 < argc; a += 2) {
+		int value = atoi(argv[a + 1]);
+		if      (strcmp(argv[a], "-s") == 0) opt.div = value;
+		else if (strcmp(argv[a], "-t") == 0) opt.threads = value;
+		else if (strcmp(argv[a], "-r") == 0) opt.base.seed = (unsigned)value;
+		else if (strcmp(argv[a], "-g") == 0) opt.base.grid = value != 0;
+		else break;
+	}
+	bool all = sweep == "all";
+	if (a < argc || !(all || sweep == "objects" || sweep == "lights" || sweep == "depth" || sweep == "mix")) {
+		fprintf(stderr, "Usage: %s [objects|lights|depth|mix|all] [-s size] [-t threads] [-r seed] [-g 0|1]\n", argv[0]);
+		return 1;
+	}
+
+	printf("sweep,value,objects,lights,depth,reflective,refractive,transparent,ms,rays,mrays_per_s,tests_per_ray\n");
+	if (all || sweep == "objects") sweepObjects(opt);
+	if (all || sweep == "lights")  sweepLights(opt);
+	if (all || sweep == "depth")   sweepDepth(opt);
+	if (all || sweep == "mix")     sweepMix(opt);
+	return 0;
+}
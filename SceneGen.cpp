@@ -0,0 +1,37 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Scene generator
+*  Prints a synthetic scene description (SceneGenerator.h).
+*
+*  Usage:  SceneGen.out [-n objects] [-l lights] [-d depth] [-r seed]
+*                       [-m reflective,refractive,transparent]
+*                       [-g 0|1 (grid)] [-w 0|1 (floor and wall)]
+*  Example:  SceneGen.out -n 200 -l 4 | RenderFile.out /dev/stdin out.ppm
+-------------------------------------------------------------*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "SceneGenerator.h"
+
+int main(int argc, char *argv[]) {
+	GeneratorSettings gen;
+	for (int a = 1; a < argc; a += 2) {
+		const char* value = (a + 1 < argc) ? argv[a + 1] : nullptr;
+		if      (!value) ;
+		else if (strcmp(argv[a], "-n") == 0) { gen.objects = atoi(value); continue; }
+		else if (strcmp(argv[a], "-l") == 0) { gen.lights = atoi(value); continue; }
+		else if (strcmp(argv[a], "-d") == 0) { gen.depth = atoi(value); continue; }
+		else if (strcmp(argv[a], "-r") == 0) { gen.seed = (unsigned)strtoul(value, nullptr, 10); continue; }
+		else if (strcmp(argv[a], "-g") == 0) { gen.grid = atoi(value) != 0; continue; }
+		else if (strcmp(argv[a], "-w") == 0) { gen.room = atoi(value) != 0; continue; }
+		else if (strcmp(argv[a], "-m") == 0 &&
+		         sscanf(value, "%f,%f,%f", &gen.reflective, &gen.refractive, &gen.transparent) == 3) continue;
+		fprintf(stderr, "Usage: %s [-n objects] [-l lights] [-d depth] [-r seed]"
+		                " [-m reflective,refractive,transparent] [-g 0|1] [-w 0|1]\n", argv[0]);
+		return 1;
+	}
+	fputs(generateScene(gen).c_str(), stdout);
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Scene generator
+*  Objects fill the box in front of the default camera that
+*  the room of RayTracer.out occupies.  Object sizes shrink
+*  with the cube root of their number, so the fraction of the
+*  view they cover stays about the same.
+-------------------------------------------------------------*/
+
+#include "SceneGenerator.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+const glm::vec3 BOX_MIN(-16, -12, -160), BOX_MAX(16, 12, -60);
+
+//std::mt19937 is specified exactly, its distributions are not.  Draws are made
+//one per statement: the order arguments are evaluated in is unspecified.
+struct Random {
+	std::mt19937 rng;
+	explicit Random(unsigned seed) : rng(seed) {}
+	float operator()() { return float(rng() / 4294967296.0); }
+	float operator()(float lo, float hi) { return lo + (hi - lo) * (*this)(); }
+	glm::vec3 operator()(glm::vec3 lo, glm::vec3 hi) {
+		glm::vec3 v;
+		v.x = (*this)(lo.x, hi.x);
+		v.y = (*this)(lo.y, hi.y);
+		v.z = (*this)(lo.z, hi.z);
+		return v;
+	}
+};
+
+struct Writer {
+	std::string text;
+	void line(const char* fmt, ...);
+};
+
+void Writer::line(const char* fmt, ...) {
+	char buf[256];
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(buf, sizeof(buf), fmt, args);
+	va_end(args);
+	text += buf;
+	text += '\n';
+}
+
+void writeQuad(Writer& w, glm::vec3 a, glm::vec3 b, glm::vec3 c, glm::vec3 d) {
+	w.line("quad  %.3f %.3f %.3f  %.3f %.3f %.3f  %.3f %.3f %.3f  %.3f %.3f %.3f",
+	       a.x, a.y, a.z, b.x, b.y, b.z, c.x, c.y, c.z, d.x, d.y, d.z);
+}
+
+//One object of a random kind and size 's' centred on 'c'
+void writeObject(Writer& w, Random& rnd, glm::vec3 c, float s) {
+	switch (int(rnd() * 5)) {
+	case 0:
+		w.line("sphere  %.3f %.3f %.3f  %.3f", c.x, c.y, c.z, s);
+		break;
+	case 1:
+		w.line("cylinder  %.3f %.3f %.3f  %.3f %.3f", c.x, c.y - s, c.z, 0.6f * s, 2 * s);
+		break;
+	case 2: {
+		float top = rnd(0, 0.5f) * s;
+		w.line("cone  %.3f %.3f %.3f  %.3f %.3f %.3f", c.x, c.y - s, c.z, 0.8f * s, top, 2 * s);
+		break;
+	}
+	case 3:
+		w.line("torus  %.3f %.3f %.3f  %.3f %.3f", c.x, c.y, c.z, 0.7f * s, 0.3f * s);
+		break;
+	default: {
+		glm::vec3 n = glm::normalize(rnd(glm::vec3(-1, -1, 0.2f), glm::vec3(1)));
+		glm::vec3 u = s * glm::normalize(glm::cross(n, glm::vec3(0, 1, 0.3f)));
+		glm::vec3 v = glm::cross(n, u);
+		writeQuad(w, c - u - v, c + u - v, c + u + v, c - u + v);
+	}
+	}
+}
+
+void writeColor(Writer& w, Random& rnd) {
+	glm::vec3 c = rnd(glm::vec3(0), glm::vec3(1));
+	w.line("color %.2f %.2f %.2f", c.r, c.g, c.b);
+}
+
+void writeMaterial(Writer& w, Random& rnd, const GeneratorSettings& gen) {
+	float u = rnd();
+	if (u < gen.reflective) {
+		writeColor(w, rnd);
+		w.line("reflect 0.8");
+	}
+	else if ((u -= gen.reflective) < gen.refractive) {
+		w.line("color 0.1 0.1 0.1");
+		w.line("reflect 0.1");
+		w.line("refract 0.9 1.5");
+	}
+	else if ((u -= gen.refractive) < gen.transparent) {
+		writeColor(w, rnd);
+		w.line("transparent 0.7");
+	}
+	else {
+		writeColor(w, rnd);
+	}
+}
+
+}
+
+/**
+* Returns the description of the scene given by 'gen'.  It holds no render
+* settings, so it renders with the defaults unless settings lines are added.
+*/
+std::string generateScene(const GeneratorSettings& gen) {
+	Random rnd(gen.seed);
+	Writer w;
+	w.line("# Generated: seed %u, %d objects, %d lights, %s", gen.seed, gen.objects, gen.lights,
+	       gen.grid ? "grid" : "random");
+	w.line("depth %d", gen.depth);
+
+	for (int l = 0; l < gen.lights; l++) {
+		glm::vec3 p = rnd(glm::vec3(-18, 10, -100), glm::vec3(18, 14, -20));
+		w.line("light  %.3f %.3f %.3f", p.x, p.y, p.z);
+	}
+
+	if (gen.room) {
+		writeQuad(w, glm::vec3(-20, -15, -40), glm::vec3(20, -15, -40),
+		          glm::vec3(20, -15, -200), glm::vec3(-20, -15, -200));
+		w.line("color 0.8 0.8 0");
+		w.line("specular 0");
+		w.line("checker");
+		writeQuad(w, glm::vec3(-20, -15, -200), glm::vec3(20, -15, -200),
+		          glm::vec3(20, 15, -200), glm::vec3(-20, 15, -200));
+		w.line("color 0.173 0.357 0.369");
+		w.line("specular 0");
+	}
+
+	glm::vec3 extent = BOX_MAX - BOX_MIN;
+	int n = std::max(gen.objects, 1);
+	if (gen.grid) {
+		int side = (int)std::ceil(std::cbrt(double(n)));
+		glm::vec3 cell = extent / float(side);
+		float s = 0.35f * std::min(cell.x, std::min(cell.y, cell.z));
+		for (int k = 0; k < gen.objects; k++) {
+			glm::vec3 idx(k % side, (k / side) % side, k / (side * side));
+			writeObject(w, rnd, BOX_MIN + (idx + glm::vec3(0.5f)) * cell, s);
+			writeMaterial(w, rnd, gen);
+		}
+	}
+	else {
+		float s = std::min(0.35f * float(std::cbrt(extent.x * extent.y * extent.z / n)), 4.0f);
+		for (int k = 0; k < gen.objects; k++) {
+			glm::vec3 c = rnd(BOX_MIN, BOX_MAX);
+			float size = rnd(0.5f, 1.0f) * s;
+			writeObject(w, rnd, c, size);
+			writeMaterial(w, rnd, gen);
+		}
+	}
+	return w.text;
+}
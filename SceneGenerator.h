@@ -0,0 +1,31 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Scene generator
+*  Writes synthetic scene descriptions (SceneParser.h) for
+*  measuring how the tracer scales with the number of objects
+*  and lights, the ray depth and the material mix.  The same
+*  settings and seed always give the same scene, on any
+*  platform.
+-------------------------------------------------------------*/
+
+#ifndef H_SCENE_GENERATOR
+#define H_SCENE_GENERATOR
+
+#include <string>
+
+struct GeneratorSettings {
+	unsigned seed = 1;
+	int   objects = 50;          //Spheres, cylinders, cones, tori and quads in equal odds
+	int   lights = 2;
+	int   depth = 5;             //Scene 'depth'
+	float reflective = 0.2f;     //Fractions of the objects; the rest are diffuse
+	float refractive = 0.1f;
+	float transparent = 0.1f;
+	bool  grid = false;          //Objects on a regular lattice instead of at random
+	bool  room = true;           //Add a checkered floor and a back wall
+};
+
+std::string generateScene(const GeneratorSettings& gen);
+
+#endif //!H_SCENE_GENERATOR
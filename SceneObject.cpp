@@ -12,6 +12,57 @@
 #include <glm/gtx/vector_query.hpp> 
 #include <cmath>
 
+/**
+* Axis-aligned box enclosing the object.  Objects that cannot be bounded
+* return false and must be treated as covering everything.
+*/
+bool SceneObject::getBounds(glm::vec3& lo, glm::vec3& hi) {
+	return false;
+}
+
+/**
+* The parts of the ray's line inside the object.  Returns false if the object
+* has no interior or cannot report one; 'spans' is then undefined.
+*/
+bool SceneObject::intervals(glm::vec3 p0, glm::vec3 dir, SpanList& spans) {
+	return false;
+}
+
+/**
+* Whether intervals() is implemented, so the object can be a CSG operand.
+*/
+bool SceneObject::hasIntervals() {
+	return false;
+}
+
+/**
+* Distance to where a ray starting inside the object leaves it, answered
+* from the object's own intervals.  Returns -1 if the ray does not start
+* inside or the object has no intervals.
+*/
+float SceneObject::exitDistance(glm::vec3 p0, glm::vec3 dir) {
+	SpanList spans;
+	if (!intervals(p0, dir, spans)) return -1;
+	for (int k = 0; k < spans.count; k++) {
+		if (spans[k].tIn <= 0 && spans[k].tOut > 0) return spans[k].tOut;
+	}
+	return -1;
+}
+
+/**
+* Tests whether a point is inside the object, by its intervals along a fixed
+* direction.
+*/
+bool SceneObject::contains(glm::vec3 p) {
+	static const glm::vec3 probe = glm::normalize(glm::vec3(0.267f, 0.873f, 0.408f));
+	SpanList spans;
+	if (!intervals(p, probe, spans)) return false;
+	for (int k = 0; k < spans.count; k++) {
+		if (spans[k].tIn <= 0 && spans[k].tOut > 0) return true;
+	}
+	return false;
+}
+
 glm::vec3 SceneObject::getColor() {
 	return color_;
 }
@@ -57,6 +108,10 @@ float SceneObject::getShininess() {
 	return shin_;
 }
 
+const Texture* SceneObject::getTexture() {
+	return tex_.get();
+}
+
 bool SceneObject::isReflective() {
 	return refl_;
 }
@@ -113,4 +168,8 @@ void SceneObject::setTransparency(bool flag) {
 void SceneObject::setTransparency(bool flag, float tran_coeff) {
 	tran_ = flag;
 	tranc_ = tran_coeff;
+}
+
+void SceneObject::setTexture(std::shared_ptr<const Texture> texture) {
+	tex_ = texture;
 }
\ No newline at end of file
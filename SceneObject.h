@@ -13,6 +13,40 @@
 #ifndef H_SOBJECT
 #define H_SOBJECT
 #include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+class Texture;
+
+/**
+* Parameter ranges tIn < t < tOut along a ray's line (t may be negative)
+* that lie inside a solid, sorted and disjoint.
+*/
+struct Span {
+	float tIn, tOut;
+};
+
+/**
+* The first INLINE spans are stored in place; nested CSG can produce more,
+* which go to the heap.
+*/
+struct SpanList {
+	static const int INLINE = 8;
+	int count = 0;
+
+	void clear() { count = 0; more_.clear(); }
+	void add(float tIn, float tOut) {
+		if (count < INLINE) first_[count] = Span{tIn, tOut};
+		else more_.push_back(Span{tIn, tOut});
+		count++;
+	}
+	Span& operator[](int k) { return (k < INLINE) ? first_[k] : more_[k - INLINE]; }
+	const Span& operator[](int k) const { return (k < INLINE) ? first_[k] : more_[k - INLINE]; }
+
+private:
+	Span first_[INLINE];
+	std::vector<Span> more_;
+};
 
 
 class SceneObject {
@@ -27,10 +61,16 @@ protected:
 	float tranc_ = 0.8;  //coefficient of transparency
 	float refri_ = 1.0;  //refractive index
 	float shin_ = 50.0; //shininess
+	std::shared_ptr<const Texture> tex_;  //texture, mapped spherically; may be shared
 public:
 	SceneObject() {}
 	virtual float intersect(glm::vec3 p0, glm::vec3 dir) = 0;
 	virtual glm::vec3 normal(glm::vec3 pos) = 0;
+	virtual bool getBounds(glm::vec3& lo, glm::vec3& hi);
+	virtual bool intervals(glm::vec3 p0, glm::vec3 dir, SpanList& spans);
+	virtual bool hasIntervals();
+	float exitDistance(glm::vec3 p0, glm::vec3 dir);
+	bool  contains(glm::vec3 p);
 	virtual ~SceneObject() {}
 
 	glm::vec3 lighting(glm::vec3 lightPos, glm::vec3 viewVec, glm::vec3 hit);
@@ -43,12 +83,14 @@ public:
 	void setSpecularity(bool flag);
 	void setTransparency(bool flag);
 	void setTransparency(bool flag, float tran_coeff);
+	void setTexture(std::shared_ptr<const Texture> texture);
 	glm::vec3 getColor();
 	float getReflectionCoeff();
 	float getRefractionCoeff();
 	float getTransparencyCoeff();
 	float getRefractiveIndex();
 	float getShininess();
+	const Texture* getTexture();
 	bool isReflective();
 	bool isRefractive();
 	bool isSpecular();
@@ -0,0 +1,239 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Scene description files
+-------------------------------------------------------------*/
+
+#include "SceneParser.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "Sphere.h"
+#include "Cylinder.h"
+#include "TruncatedCone.h"
+#include "Torus.h"
+#include "Plane.h"
+#include "CSG.h"
+
+static const int   MAX_DEPTH = 32;           //Deeper paths could overflow a render thread's stack
+static const float MAX_SHININESS = 10000.0f;
+
+static bool isSettingKeyword(const std::string& word) {
+	return word == "camera" || word == "size" || word == "samples"
+	    || word == "visibility" || word == "culling" || word == "fastmath" || word == "denoise";
+}
+
+/**
+* Splits a description into its scene part and its settings part, each in a
+* canonical form: comments and blank lines removed, tokens separated by single
+* spaces.  Equal canonical text means an identical scene (or settings).
+*/
+void splitDescription(const std::string& text, std::string& sceneText, std::string& settingsText) {
+	sceneText.clear();
+	settingsText.clear();
+	std::istringstream in(text);
+	std::string line;
+	while (std::getline(in, line)) {
+		size_t hash = line.find('#');
+		if (hash != std::string::npos) line.erase(hash);
+		std::istringstream words(line);
+		std::string word, canon;
+		while (words >> word) canon += (canon.empty() ? "" : " ") + word;
+		if (canon.empty()) continue;
+		std::string first = canon.substr(0, canon.find(' '));
+		(isSettingKeyword(first) ? settingsText : sceneText) += canon + "\n";
+	}
+}
+
+static glm::vec3 readVec(std::istream& in) {
+	float x, y, z;
+	in >> x >> y >> z;
+	return glm::vec3(x, y, z);
+}
+
+/**
+* Parses a description.  Scene lines are applied to 'scene' and settings lines
+* to 'settings' / 'denoise'; lines whose target is null are skipped.  The scene
+* is finalized on success.  On failure 'error' names the offending line.
+*/
+bool parseDescription(const std::string& text, Scene* scene, RenderSettings* settings,
+                      bool* denoise, std::string& error)
+{
+	std::istringstream in(text);
+	std::string line;
+	int lineNo = 0;
+	SceneObject* last = nullptr;
+	while (std::getline(in, line)) {
+		lineNo++;
+		size_t hash = line.find('#');
+		if (hash != std::string::npos) line.erase(hash);
+		std::istringstream ls(line);
+		std::string word;
+		if (!(ls >> word)) continue;
+
+		bool setting = isSettingKeyword(word);
+		if ((setting && !settings) || (!setting && !scene)) continue;
+
+		SceneObject* obj = nullptr;
+		if (word == "sphere") {
+			glm::vec3 c = readVec(ls); float r; ls >> r;
+			obj = new Sphere(c, r);
+		}
+		else if (word == "cylinder") {
+			glm::vec3 c = readVec(ls); float r, h; ls >> r >> h;
+			obj = new Cylinder(c, r, h);
+		}
+		else if (word == "cone") {
+			glm::vec3 c = readVec(ls); float r1, r2, h; ls >> r1 >> r2 >> h;
+			obj = new TruncatedCone(c, r1, r2, h);
+		}
+		else if (word == "torus") {
+			glm::vec3 c = readVec(ls); float R, r; ls >> R >> r;
+			obj = new Torus(c, R, r);
+		}
+		else if (word == "quad") {
+			glm::vec3 a = readVec(ls), b = readVec(ls), c = readVec(ls), d = readVec(ls);
+			obj = new Plane(a, b, c, d);
+		}
+		else if (word == "triangle") {
+			glm::vec3 a = readVec(ls), b = readVec(ls), c = readVec(ls);
+			obj = new Plane(a, b, c);
+		}
+		else if (word == "union" || word == "intersect" || word == "subtract") {
+			size_t n = scene->objects.size();
+			if (n < 2) {
+				error = "line " + std::to_string(lineNo) + ": '" + word + "' needs two objects before it";
+				return false;
+			}
+			if (!scene->objects[n - 2]->hasIntervals() || !scene->objects[n - 1]->hasIntervals()) {
+				error = "line " + std::to_string(lineNo) + ": '" + word + "' needs solid operands (sphere, cylinder, cone or csg)";
+				return false;
+			}
+			std::shared_ptr<SceneObject> a(scene->objects[n - 2]), b(scene->objects[n - 1]);
+			scene->objects.resize(n - 2);
+			if (scene->checkeredObject >= int(n - 2)) scene->checkeredObject = -1;
+			CSG::Op op = (word == "union") ? CSG::UNION
+			           : (word == "intersect") ? CSG::INTERSECTION : CSG::DIFFERENCE;
+			obj = new CSG(op, a, b);
+		}
+		else if (word == "light") {
+			scene->addLight(readVec(ls));
+		}
+		else if (word == "depth") {
+			ls >> scene->maxDepth;
+			if (!ls.fail() && (scene->maxDepth < 1 || scene->maxDepth > MAX_DEPTH)) {
+				error = "line " + std::to_string(lineNo) + ": depth must be 1 to " + std::to_string(MAX_DEPTH);
+				return false;
+			}
+		}
+		else if (word == "cutoff") {
+			ls >> scene->cutoff;
+			if (!ls.fail() && !(scene->cutoff >= 0.0f && scene->cutoff <= 1.0f)) {
+				error = "line " + std::to_string(lineNo) + ": cutoff must be 0 to 1";
+				return false;
+			}
+		}
+		else if (word == "roulette") {
+			int v; ls >> v;
+			scene->roulette = v != 0;
+		}
+		else if (word == "camera") {
+			settings->camera.eye = readVec(ls);
+			ls >> settings->camera.yaw >> settings->camera.pitch;
+		}
+		else if (word == "size") {
+			ls >> settings->div;
+		}
+		else if (word == "samples") {
+			ls >> settings->grid;
+		}
+		else if (word == "visibility") {
+			int v; ls >> v;
+			settings->rasterVisibility = v != 0;
+		}
+		else if (word == "culling") {
+			int v; ls >> v;
+			settings->tileCulling = v != 0;
+		}
+		else if (word == "fastmath") {
+			int v; ls >> v;
+			settings->fastMath = v != 0;
+		}
+		else if (word == "denoise") {
+			int v; ls >> v;
+			if (denoise) *denoise = v != 0;
+		}
+		else if (last == nullptr) {
+			error = "line " + std::to_string(lineNo) + ": '" + word + "' needs an object before it";
+			return false;
+		}
+		else if (word == "color") {
+			last->setColor(readVec(ls));
+		}
+		else if (word == "reflect") {
+			float k; ls >> k;
+			last->setReflectivity(true, k);
+		}
+		else if (word == "refract") {
+			float k, eta; ls >> k >> eta;
+			last->setRefractivity(true, k, eta);
+		}
+		else if (word == "transparent") {
+			float k; ls >> k;
+			last->setTransparency(true, k);
+		}
+		else if (word == "specular") {
+			int v; ls >> v;
+			last->setSpecularity(v != 0);
+		}
+		else if (word == "shininess") {
+			float s; ls >> s;
+			if (!ls.fail() && !(s >= 0.0f && s <= MAX_SHININESS)) {
+				error = "line " + std::to_string(lineNo) + ": shininess must be 0 to 10000";
+				return false;
+			}
+			last->setShininess(s);
+		}
+		else if (word == "texture") {
+			std::string file; ls >> file;
+			std::shared_ptr<Texture> texture = scene->textures->load(file);
+			if (!texture) {
+				error = "line " + std::to_string(lineNo) + ": cannot load texture " + file;
+				return false;
+			}
+			last->setTexture(texture);
+		}
+		else if (word == "checker") {
+			scene->checkeredObject = (int)scene->objects.size() - 1;
+		}
+		else {
+			error = "line " + std::to_string(lineNo) + ": unknown keyword '" + word + "'";
+			return false;
+		}
+
+		if (ls.fail()) {
+			delete obj;
+			error = "line " + std::to_string(lineNo) + ": bad or missing values for '" + word + "'";
+			return false;
+		}
+		if (obj) {
+			scene->add(obj);
+			last = obj;
+		}
+	}
+	if (scene) scene->finalize();
+	return true;
+}
+
+bool loadSceneFile(const char* path, Scene& scene, RenderSettings& settings,
+                   bool& denoise, std::string& error)
+{
+	std::ifstream file(path);
+	if (!file) {
+		error = std::string("cannot open ") + path;
+		return false;
+	}
+	std::stringstream buf;
+	buf << file.rdbuf();
+	return parseDescription(buf.str(), &scene, &settings, &denoise, error);
+}
@@ -0,0 +1,48 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Scene description files
+*  A line-based text format for scenes and render settings, so
+*  scenes can be built by other programs.  '#' starts a comment.
+*
+*  Objects:
+*      sphere    cx cy cz radius
+*      cylinder  cx cy cz radius height
+*      cone      cx cy cz baseRadius topRadius height
+*      torus     cx cy cz majorRadius minorRadius
+*      quad      ax ay az  bx by bz  cx cy cz  dx dy dz
+*      triangle  ax ay az  bx by bz  cx cy cz
+*      light     x y z
+*      depth     n    (most rays in one path, primary ray included; 1-32, default 5)
+*      cutoff    w    (secondary rays of throughput below w are dropped; 0-1, default 1/512)
+*      roulette  0|1  (instead, keep them with probability throughput / w, unbiased: only pixels are clamped)
+*      union | intersect | subtract
+*                replaces the two most recent objects a, b by a CSG
+*                object (a + b, a * b or a - b); both must be spheres,
+*                cylinders, cones or CSG objects
+*  Material of the most recent object:
+*      color r g b        reflect coeff        refract coeff index
+*      transparent coeff  specular 0|1         shininess s (0-10000)
+*      texture file       (BMP or PFM; loading a file again shares it)
+*      checker
+*  Render settings:
+*      camera ex ey ez yaw pitch    size div    samples grid
+*      visibility 0|1    culling 0|1    fastmath 0|1    denoise 0|1
+-------------------------------------------------------------*/
+
+#ifndef H_SCENE_PARSER
+#define H_SCENE_PARSER
+
+#include <string>
+#include "Scene.h"
+#include "RenderJob.h"
+
+void splitDescription(const std::string& text, std::string& sceneText, std::string& settingsText);
+
+bool parseDescription(const std::string& text, Scene* scene, RenderSettings* settings,
+                      bool* denoise, std::string& error);
+
+bool loadSceneFile(const char* path, Scene& scene, RenderSettings& settings,
+                   bool& denoise, std::string& error);
+
+#endif //!H_SCENE_PARSER
@@ -40,3 +40,27 @@ glm::vec3 Sphere::normal(glm::vec3 p) {
 	n = glm::normalize(n);
 	return n;
 }
+
+/**
+* The chord of the ray's line through the sphere, with the same roots and
+* grazing cut-off as intersect().
+*/
+bool Sphere::intervals(glm::vec3 p0, glm::vec3 dir, SpanList& spans) {
+	glm::vec3 vdif = p0 - center;
+	float b = glm::dot(dir, vdif);
+	float len = glm::length(vdif);
+	float c = len*len - radius*radius;
+	float delta = b*b - c;
+
+	if(delta < 0.001) return false;
+
+	spans.clear();
+	spans.add(-b - sqrt(delta), -b + sqrt(delta));
+	return true;
+}
+
+bool Sphere::getBounds(glm::vec3& lo, glm::vec3& hi) {
+	lo = center - glm::vec3(radius);
+	hi = center + glm::vec3(radius);
+	return true;
+}
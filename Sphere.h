@@ -28,6 +28,11 @@ public:
 	float intersect(glm::vec3 p0, glm::vec3 dir);
 
 	glm::vec3 normal(glm::vec3 p);
+
+	bool getBounds(glm::vec3& lo, glm::vec3& hi);
+
+	bool intervals(glm::vec3 p0, glm::vec3 dir, SpanList& spans);
+	bool hasIntervals() { return true; }
 };
 
 #endif //!H_SPHERE
@@ -0,0 +1,110 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Streaming render
+*  The calling thread submits the tiles of each band to the
+*  pool as soon as the window has room; the tiles encode
+*  their rows straight into the band's bytes.  Must not be
+*  called from a task on the same pool.
+-------------------------------------------------------------*/
+
+#include "StreamRender.h"
+#include "ImageIO.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+struct Band {
+	int j0, j1;                          //Rows [j0, j1); j0 is the lowest
+	std::vector<unsigned char> rgb;      //Top row first, as in the file
+	int tilesLeft;
+};
+
+}
+
+/**
+* Renders 'settings' to the PPM at 'path', holding at most 'window' bands.
+* Denoising needs the whole image and is not available here.
+*/
+bool streamRender(ThreadPool& pool, std::shared_ptr<const Scene> scene, const RenderSettings& settings,
+                  const std::string& path, int window, std::string& error, StreamStats* stats)
+{
+	std::ofstream out(path, std::ios::binary);
+	if (!out) {
+		error = "Cannot write " + path;
+		return false;
+	}
+	out << ppmHeader(settings.div, settings.div);
+
+	int div = settings.div, ts = settings.tileSize;
+	int bands = (div + ts - 1) / ts;
+	window = std::max(window, 1);
+
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::deque<std::unique_ptr<Band>> held;   //Bands not yet written, top band first
+	size_t heldBytes = 0;
+	StreamStats st;
+	st.bands = bands;
+
+	std::thread writer([&] {
+		for (int b = 0; b < bands; b++) {
+			Band* band;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				changed.wait(lock, [&] { return !held.empty() && held.front()->tilesLeft == 0; });
+				band = held.front().get();
+			}
+			if (out) out.write((const char*)band->rgb.data(), band->rgb.size());
+			std::lock_guard<std::mutex> lock(mutex);
+			heldBytes -= band->rgb.size();
+			held.pop_front();
+			changed.notify_all();
+		}
+	});
+
+	for (int b = 0; b < bands; b++) {
+		std::unique_ptr<Band> band(new Band);
+		band->j1 = div - b * ts;
+		band->j0 = std::max(band->j1 - ts, 0);
+		band->tilesLeft = (div + ts - 1) / ts;
+		Band* bp = band.get();
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [&] { return (int)held.size() < window; });
+			bp->rgb.resize(3 * size_t(div) * (bp->j1 - bp->j0));
+			heldBytes += bp->rgb.size();
+			st.peakBytes = std::max(st.peakBytes, heldBytes);
+			held.push_back(std::move(band));
+		}
+
+		for (int i0 = 0; i0 < div; i0 += ts) {
+			int i1 = std::min(i0 + ts, div);
+			pool.submit(settings.priority, [&, bp, i0, i1] {
+				GBuffer tile;
+				tile.resize(i1 - i0, bp->j1 - bp->j0);
+				RenderContext ctx{ scene.get(), &settings.camera, div, settings.grid, &tile, i0, bp->j0 };
+				ctx.fastMath = settings.fastMath;
+				renderRegion(ctx, i0, bp->j0, i1, bp->j1, settings.rasterVisibility, settings.tileCulling);
+				for (int j = bp->j0; j < bp->j1; j++) {
+					size_t row = bp->j1 - 1 - j;
+					encodeRGB(&tile.color[(j - bp->j0) * tile.width], tile.width, &bp->rgb[3 * (row * div + i0)]);
+				}
+				std::lock_guard<std::mutex> lock(mutex);
+				if (--bp->tilesLeft == 0) changed.notify_all();
+			});
+		}
+	}
+	writer.join();
+
+	if (stats) *stats = st;
+	if (!out.flush()) {
+		error = "Error writing " + path;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,33 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Streaming render
+*  Renders straight to a PPM file without holding the image.
+*  The image is traced in bands of one tile row, top band
+*  first.  A writer thread appends finished bands to the file
+*  in order while later bands are still tracing, and at most
+*  'window' bands are held at once (tracing or waiting to be
+*  written), so memory grows with the image width, not its
+*  area.  Tiles finish in any order within the window.
+*
+*  Usage:
+*      std::string error;
+*      if (!streamRender(pool, scene, settings, "poster.ppm", 4, error)) ...
+-------------------------------------------------------------*/
+
+#ifndef H_STREAM_RENDER
+#define H_STREAM_RENDER
+
+#include <memory>
+#include <string>
+#include "RenderJob.h"
+
+struct StreamStats {
+	int    bands = 0;
+	size_t peakBytes = 0;        //Largest total size of the bands held at once
+};
+
+bool streamRender(ThreadPool& pool, std::shared_ptr<const Scene> scene, const RenderSettings& settings,
+                  const std::string& path, int window, std::string& error, StreamStats* stats = nullptr);
+
+#endif //!H_STREAM_RENDER
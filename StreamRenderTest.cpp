@@ -0,0 +1,80 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Streaming render test
+*  Renders a scene whose size is not a whole number of tiles
+*  with streamRender() at several window sizes and checks that
+*  each file is byte for byte the PPM writePPM() saves from a
+*  RenderJob of the same settings, that no more than 'window'
+*  bands were held at once, and that an unwritable path is
+*  reported.  Exits with 1 on the first failure.
+-------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "StreamRender.h"
+#include "SceneParser.h"
+#include "ImageIO.h"
+
+static const char* SCENE =
+	"light 10 15 5\n"
+	"light -12 8 -10\n"
+	"sphere -4 0 -40 5\n"     "color 1 0 0\n"
+	"sphere 6 -2 -35 3\n"     "color 0.2 0.4 1\n"   "reflect 0.6\n"
+	"cylinder 0 -9 -55 3 8\n" "color 0.3 0.9 0.3\n"
+	"quad -30 -9 0  30 -9 0  30 -9 -100  -30 -9 -100\n"
+	"checker\n"
+	"size 100\n";
+
+static void check(bool ok, const char* what) {
+	printf("%s  %s\n", ok ? "ok  " : "FAIL", what);
+	if (!ok) exit(1);
+}
+
+static std::string readFile(const std::string& path) {
+	std::ifstream file(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+int main() {
+	std::shared_ptr<Scene> scene = std::make_shared<Scene>();
+	RenderSettings settings;
+	std::string error;
+	if (!parseDescription(SCENE, scene.get(), &settings, nullptr, error)) {
+		fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+	ThreadPool pool(2);
+
+	std::string oneShot = "/tmp/stream-test-oneshot.ppm";
+	std::shared_ptr<RenderJob> job = RenderJob::start(pool, scene, settings);
+	job->wait();
+	check(writePPM(oneShot.c_str(), job->snapshot()), "the one-shot image is written");
+	std::string expected = readFile(oneShot);
+	std::remove(oneShot.c_str());
+
+	size_t bandBytes = 3 * size_t(settings.div) * settings.tileSize;
+	int bands = (settings.div + settings.tileSize - 1) / settings.tileSize;
+	for (int window : { 1, 2, 8 }) {
+		std::string path = "/tmp/stream-test-" + std::to_string(window) + ".ppm";
+		StreamStats stats;
+		bool ok = streamRender(pool, scene, settings, path, window, error, &stats);
+		std::string streamed = readFile(path);
+		std::remove(path.c_str());
+
+		char what[96];
+		snprintf(what, sizeof(what), "window %d: the bands make the one-shot PPM", window);
+		check(ok && streamed == expected, what);
+		snprintf(what, sizeof(what), "window %d: the bands held at once fit the window", window);
+		check(stats.bands == bands && stats.peakBytes <= size_t(std::min(window, bands)) * bandBytes, what);
+	}
+
+	check(!streamRender(pool, scene, settings, "/nonexistent/dir/out.ppm", 2, error) && !error.empty(),
+	      "an unwritable path is reported");
+	printf("All streaming render checks passed\n");
+	return 0;
+}
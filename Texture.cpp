@@ -0,0 +1,277 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Texture class
+*  Reads uncompressed 24- and 32-bit BMP files (rows padded to
+*  4 bytes, bottom-up or top-down) and colour or greyscale PFM
+*  files.  Texel (i, j) is column i of row j counted from the
+*  bottom of the image.
+-------------------------------------------------------------*/
+
+#include "Texture.h"
+#include "TextureManager.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//Size and modification time, which change whenever the file is rewritten
+static std::string identityOf(const struct stat& st) {
+	return std::to_string((long long)st.st_size) + " " + std::to_string((long long)st.st_mtim.tv_sec)
+	       + "." + std::to_string((long long)st.st_mtim.tv_nsec);
+}
+
+static const long MAX_PFM_SIDE = 1 << 20;        //Largest width or height parsePFM() accepts
+static const int PINNED_TILES = 16;              //Tiles each thread keeps pinned; a power of 2
+
+//Parses a whole decimal field in [1, MAX_PFM_SIDE]; false if it is anything else
+static bool parseSide(const std::string& field, int& side) {
+	char* end;
+	errno = 0;
+	long v = strtol(field.c_str(), &end, 10);
+	if (field.empty() || *end != '\0' || errno == ERANGE || v < 1 || v > MAX_PFM_SIDE) return false;
+	side = int(v);
+	return true;
+}
+
+//The low TILE_BITS bits of v spread to the even bit positions
+static inline unsigned spreadBits(unsigned v) {
+	v &= 0xff;
+	v = (v | (v << 4)) & 0x0f0f;
+	v = (v | (v << 2)) & 0x3333;
+	v = (v | (v << 1)) & 0x5555;
+	return v;
+}
+
+//Position of texel (x, y) of a tile in Morton order
+static inline unsigned morton(int x, int y) {
+	return spreadBits(x) | (spreadBits(y) << 1);
+}
+
+static uint32_t read32(const unsigned char* p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+}
+
+static uint16_t read16(const unsigned char* p) {
+	return uint16_t(p[0] | (p[1] << 8));
+}
+
+//True if 'rows' rows of 'stride' bytes starting at 'offset' lie within 'size'
+//bytes.  Each value is checked on its own so a crafted header cannot overflow.
+static bool fitsIn(size_t offset, size_t stride, size_t rows, size_t size) {
+	if (offset > size) return false;
+	return stride == 0 || rows <= (size - offset) / stride;
+}
+
+Texture::Texture(std::shared_ptr<TextureManager> manager, const std::string& path)
+	: manager_(manager), path_(path)
+{
+	static std::atomic<uint64_t> nextSerial{1};
+	serial_ = nextSerial++;
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) return;
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		identity_ = identityOf(st);
+		void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED) {
+			map_ = (const unsigned char*)p;
+			mapSize_ = st.st_size;
+		}
+	}
+	close(fd);
+	if (!map_) return;
+
+	bool ok = false;
+	if (mapSize_ >= 2 && map_[0] == 'B' && map_[1] == 'M') ok = parseBMP();
+	else if (mapSize_ >= 2 && map_[0] == 'P' && (map_[1] == 'F' || map_[1] == 'f')) ok = parsePFM();
+	if (!ok) {
+		width_ = height_ = 0;
+		return;
+	}
+
+	tilesX_ = (width_ + TILE - 1) / TILE;
+	tilesY_ = (height_ + TILE - 1) / TILE;
+	tiles_.resize(tilesX_ * tilesY_);
+	used_.reset(new std::atomic<bool>[tilesX_ * tilesY_]);
+	for (int k = 0; k < tilesX_ * tilesY_; k++) used_[k] = false;
+}
+
+Texture::~Texture() {
+	if (manager_) manager_->forget(this);
+	if (map_) munmap((void*)map_, mapSize_);
+}
+
+bool Texture::parseBMP() {
+	if (mapSize_ < 54) return false;
+	uint32_t offset = read32(map_ + 10);
+	int32_t  wid = (int32_t)read32(map_ + 18);
+	int32_t  hgt = (int32_t)read32(map_ + 22);
+	uint16_t bpp = read16(map_ + 28);
+	uint32_t compression = read32(map_ + 30);
+	if ((bpp != 24 && bpp != 32) || (compression != 0 && compression != 3) || wid <= 0 || hgt == 0
+	    || hgt == INT32_MIN)
+		return false;
+
+	topDown_ = hgt < 0;
+	width_ = wid;
+	height_ = std::abs(hgt);
+	fileBytesPerTexel_ = bpp / 8;
+	rowStride_ = (size_t(width_) * bpp + 31) / 32 * 4;
+	dataOffset_ = offset;
+	format_ = UNORM8;
+	return fitsIn(dataOffset_, rowStride_, height_, mapSize_);
+}
+
+bool Texture::parsePFM() {
+	//Header: "PF" or "Pf", width, height and scale, each followed by white space
+	std::string fields[4];
+	size_t p = 0;
+	for (int f = 0; f < 4; f++) {
+		while (p < mapSize_ && isspace(map_[p])) p++;
+		while (p < mapSize_ && !isspace(map_[p])) fields[f] += char(map_[p++]);
+	}
+	p++;    //The single white space character before the data
+
+	int channels = (fields[0] == "PF") ? 3 : 1;
+	if (!parseSide(fields[1], width_) || !parseSide(fields[2], height_)) return false;
+	float scale = (float)atof(fields[3].c_str());
+	if (scale == 0) return false;
+
+	const uint16_t probe = 1;
+	bool hostLittle = *(const unsigned char*)&probe == 1;
+	swapBytes_ = (scale < 0) != hostLittle;
+	topDown_ = false;
+	fileBytesPerTexel_ = 4 * channels;
+	rowStride_ = size_t(width_) * fileBytesPerTexel_;
+	dataOffset_ = p;
+	format_ = FLOAT32;
+	return fitsIn(dataOffset_, rowStride_, height_, mapSize_);
+}
+
+size_t Texture::texelBytes() const {
+	return (format_ == UNORM8) ? 3 : 3 * sizeof(float);
+}
+
+/**
+* Copies one tile out of the mapped file.  Texels beyond the image edge are black.
+*/
+std::shared_ptr<const Texture::Tile> Texture::decodeTile(int tile) const {
+	std::shared_ptr<Tile> out = std::make_shared<Tile>();
+	size_t tb = texelBytes();
+	out->bytes.assign(TILE * TILE * tb, 0);
+	int i0 = (tile % tilesX_) * TILE, j0 = (tile / tilesX_) * TILE;
+
+	for (int y = 0; y < TILE && j0 + y < height_; y++) {
+		int row = topDown_ ? height_ - 1 - (j0 + y) : j0 + y;
+		const unsigned char* src = map_ + dataOffset_ + row * rowStride_ + size_t(i0) * fileBytesPerTexel_;
+		for (int x = 0; x < TILE && i0 + x < width_; x++, src += fileBytesPerTexel_) {
+			unsigned char* dst = &out->bytes[morton(x, y) * tb];
+			if (format_ == UNORM8) {
+				dst[0] = src[2];    //BMP stores blue, green, red
+				dst[1] = src[1];
+				dst[2] = src[0];
+			}
+			else {
+				float rgb[3];
+				for (int c = 0; c < 3; c++) {
+					unsigned char b[4];
+					memcpy(b, src + 4 * (fileBytesPerTexel_ == 12 ? c : 0), 4);
+					if (swapBytes_) { std::swap(b[0], b[3]); std::swap(b[1], b[2]); }
+					memcpy(&rgb[c], b, 4);
+				}
+				memcpy(dst, rgb, sizeof(rgb));
+			}
+		}
+	}
+	return out;
+}
+
+bool Texture::isValid() const {
+	return width_ > 0 && height_ > 0;
+}
+
+/**
+* Tile 'tile', paged in if need be and pinned by this thread.  The atomic load
+* of tiles_ takes a lock in libstdc++, so it is done only when the tile is not
+* among the calling thread's pinned tiles.  The pointer stays valid until this
+* thread pins PINNED_TILES other tiles.
+*/
+const Texture::Tile* Texture::pin(int tile) const {
+	struct Pinned {
+		uint64_t texture = 0;
+		int tile = -1;
+		std::shared_ptr<const Tile> data;
+	};
+	static thread_local Pinned pinned[PINNED_TILES];
+
+	Pinned& slot = pinned[(serial_ * 7 + tile) & (PINNED_TILES - 1)];
+	if (slot.texture != serial_ || slot.tile != tile) {
+		std::shared_ptr<const Tile> data = std::atomic_load(&tiles_[tile]);
+		if (!data) data = manager_->pageIn(const_cast<Texture&>(*this), tile);
+		slot.texture = serial_;
+		slot.tile = tile;
+		slot.data = std::move(data);
+	}
+	return slot.data.get();
+}
+
+/**
+* Colour of texel (i, j); (i, j) must lie inside the image.
+*/
+glm::vec3 Texture::texel(int i, int j) const {
+	int k = (j >> TILE_BITS) * tilesX_ + (i >> TILE_BITS);
+	const Tile* tile = pin(k);
+	if (!used_[k].load(std::memory_order_relaxed)) used_[k].store(true, std::memory_order_relaxed);
+
+	const unsigned char* p = &tile->bytes[morton(i & (TILE - 1), j & (TILE - 1)) * texelBytes()];
+	if (format_ == UNORM8) return glm::vec3(p[0] / 255.0, p[1] / 255.0, p[2] / 255.0);
+	float rgb[3];
+	memcpy(rgb, p, sizeof(rgb));
+	return glm::vec3(rgb[0], rgb[1], rgb[2]);
+}
+
+/**
+* Return color at texture coord (s, t) where s and t are in [0,1]
+*/
+glm::vec3 Texture::getColorAt(float s, float t) const {
+	if (width_ == 0 || height_ == 0) return glm::vec3(0);
+	int i = (int)(s * width_);     //Nearest texel
+	int j = (int)(t * height_);
+	if (i < 0 || i > width_ - 1 || j < 0 || j > height_ - 1) return glm::vec3(0);
+	return texel(i, j);
+}
+
+int Texture::getWidth() const {
+	return width_;
+}
+
+int Texture::getHeight() const {
+	return height_;
+}
+
+const std::string& Texture::getPath() const {
+	return path_;
+}
+
+/**
+* True if the file has not been rewritten since it was mapped.
+*/
+bool Texture::isCurrent() const {
+	return !identity_.empty() && identify(path_) == identity_;
+}
+
+/**
+* The size and modification time of the file at 'path', or "" if it cannot
+* be read.  Textures of the same path and identity hold the same texels.
+*/
+std::string Texture::identify(const std::string& path) {
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0) return "";
+	return identityOf(st);
+}
@@ -0,0 +1,84 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Texture class
+*  An image used to colour objects, created by a TextureManager.
+*  The file stays memory-mapped and texels are copied out of it
+*  a 32 x 32 tile at a time, the first time a tile is looked
+*  up, into unsigned bytes (BMP) or floats (PFM) stored in
+*  Morton order, so that nearby texels share cache lines in
+*  both directions.  The manager may drop tiles again to stay
+*  within its memory budget; lookups are safe from any number
+*  of threads.  Each thread pins the last few tiles it used, so
+*  coherent lookups go to the shared tile table only on a miss;
+*  a dropped tile is freed once no thread has it pinned.
+-------------------------------------------------------------*/
+
+#ifndef H_TEXTURE
+#define H_TEXTURE
+
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TextureManager;
+
+class Texture {
+public:
+	enum Format { UNORM8, FLOAT32 };            //Texel storage: 3 bytes or 3 floats
+
+	static const int TILE_BITS = 5;
+	static const int TILE = 1 << TILE_BITS;     //Texels per tile side
+
+private:
+	friend class TextureManager;
+
+	//Decoded texels of one tile, in Morton order
+	struct Tile {
+		std::vector<unsigned char> bytes;
+	};
+
+	std::shared_ptr<TextureManager> manager_;
+	std::string path_;
+	std::string identity_;                      //Size and modification time of the file when mapped
+	uint64_t serial_;                           //Unique per texture, unlike its address
+	const unsigned char* map_ = nullptr;        //The mapped file
+	size_t mapSize_ = 0;
+	size_t dataOffset_ = 0;                     //First byte of texel data in the file
+	size_t rowStride_ = 0;                      //Bytes per row in the file, padding included
+	int  fileBytesPerTexel_ = 0;
+	bool topDown_ = false;                      //File rows run from the top of the image
+	bool swapBytes_ = false;                    //Float data of the other endianness
+	Format format_ = UNORM8;
+	int width_ = 0, height_ = 0;
+	int tilesX_ = 0, tilesY_ = 0;
+	std::vector<std::shared_ptr<const Tile>> tiles_;   //Null until paged in; use atomic loads, via pin()
+	std::unique_ptr<std::atomic<bool>[]> used_;        //Per tile: looked up since the last eviction sweep
+
+	bool parseBMP();
+	bool parsePFM();
+	std::shared_ptr<const Tile> decodeTile(int tile) const;
+	const Tile* pin(int tile) const;
+	size_t texelBytes() const;
+
+public:
+	Texture(std::shared_ptr<TextureManager> manager, const std::string& path);
+	~Texture();
+	Texture(const Texture&) = delete;
+	Texture& operator=(const Texture&) = delete;
+
+	bool isValid() const;
+	glm::vec3 texel(int i, int j) const;
+	glm::vec3 getColorAt(float s, float t) const;
+	int getWidth() const;
+	int getHeight() const;
+	const std::string& getPath() const;
+	bool isCurrent() const;
+
+	static std::string identify(const std::string& path);
+};
+
+#endif //!H_TEXTURE
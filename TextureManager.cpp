@@ -0,0 +1,169 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The TextureManager class
+*  Renders hold their own reference to each tile they read
+*  (Texture::tiles_ is accessed atomically, and each thread
+*  keeps its last few tiles pinned), so a tile dropped during a
+*  render is freed only once no thread has it pinned.  Pinned
+*  tiles may keep the memory in use a little over the budget.
+-------------------------------------------------------------*/
+
+#include "TextureManager.h"
+#include <iostream>
+
+TextureManager::TextureManager(size_t budget) : budget_(budget) {}
+
+/**
+* Returns the texture in the named file, or null if it cannot be read or the
+* name is not allowed (see confine()).
+*/
+std::shared_ptr<Texture> TextureManager::load(const std::string& name) {
+	std::string path;
+	if (!resolve(name, path)) {
+		std::cerr << "*** Texture " << name << " is outside the texture directory" << std::endl;
+		return nullptr;
+	}
+	std::shared_ptr<Texture> texture;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = loaded_.find(path);
+		if (it != loaded_.end()) texture = it->second.lock();
+	}
+	if (texture && texture->isCurrent()) return texture;
+
+	texture = std::make_shared<Texture>(shared_from_this(), path);
+	if (!texture->isValid()) {
+		std::cerr << "*** Could not load texture " << path << std::endl;
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::shared_ptr<Texture> other = loaded_[path].lock();
+	if (other && other->isCurrent()) return other;    //Loaded by another thread meanwhile
+	loaded_[path] = texture;
+	return texture;
+}
+
+/**
+* From now on, loads only relative names without ".." components, read from
+* under 'dir'.  An empty 'dir' refuses every name.
+*/
+void TextureManager::confine(const std::string& dir) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	confined_ = true;
+	root_ = dir;
+}
+
+/**
+* Sets 'path' to the file 'name' refers to.  False if the name is not allowed.
+*/
+bool TextureManager::resolve(const std::string& name, std::string& path) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!confined_) {
+		path = name;
+		return true;
+	}
+	if (root_.empty() || name.empty() || name[0] == '/') return false;
+	for (size_t start = 0; start <= name.size(); ) {
+		size_t end = name.find('/', start);
+		if (end == std::string::npos) end = name.size();
+		if (name.compare(start, end - start, "..") == 0) return false;
+		start = end + 1;
+	}
+	path = root_ + "/" + name;
+	return true;
+}
+
+/**
+* The path, size and modification time of the file 'name' refers to, or ""
+* if it is not allowed or cannot be read.  Scenes whose textures have the
+* same identities render alike.
+*/
+std::string TextureManager::identify(const std::string& name) {
+	std::string path;
+	if (!resolve(name, path)) return "";
+	std::string identity = Texture::identify(path);
+	return identity.empty() ? "" : path + " " + identity;
+}
+
+/**
+* Decodes a tile of 'texture' and makes room for it.  The tile is decoded
+* without the lock, so other lookups are not held up, and published under it.
+* Another thread may have published the tile first, in which case that copy
+* is returned and this one dropped.
+*/
+std::shared_ptr<const Texture::Tile> TextureManager::pageIn(Texture& texture, int tile) {
+	std::shared_ptr<const Texture::Tile> data = std::atomic_load(&texture.tiles_[tile]);
+	if (data) return data;
+	data = texture.decodeTile(tile);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::shared_ptr<const Texture::Tile> other = std::atomic_load(&texture.tiles_[tile]);
+	if (other) return other;
+	size_t bytes = data->bytes.size();
+	evictFor(bytes);
+	std::atomic_store(&texture.tiles_[tile], data);
+	texture.used_[tile] = true;
+	resident_.push_back(Resident{ &texture, tile, bytes });
+	residentBytes_ += bytes;
+	tileLoads_++;
+	return data;
+}
+
+/**
+* Drops tiles until 'bytes' more fit in the budget.  A tile looked up since the
+* hand last passed it gets a second chance.  Must be called with mutex_ held.
+*/
+void TextureManager::evictFor(size_t bytes) {
+	size_t steps = 2 * resident_.size();
+	while (residentBytes_ + bytes > budget_ && !resident_.empty() && steps-- > 0) {
+		if (clockHand_ >= resident_.size()) clockHand_ = 0;
+		Resident& r = resident_[clockHand_];
+		if (r.texture->used_[r.tile].exchange(false)) {
+			clockHand_++;
+			continue;
+		}
+		std::atomic_store(&r.texture->tiles_[r.tile], std::shared_ptr<const Texture::Tile>());
+		residentBytes_ -= r.bytes;
+		evictions_++;
+		r = resident_.back();
+		resident_.pop_back();
+	}
+}
+
+//Called by a texture that is being destroyed
+void TextureManager::forget(Texture* texture) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	for (size_t k = 0; k < resident_.size(); ) {
+		if (resident_[k].texture == texture) {
+			residentBytes_ -= resident_[k].bytes;
+			resident_[k] = resident_.back();
+			resident_.pop_back();
+		}
+		else k++;
+	}
+	auto it = loaded_.find(texture->getPath());
+	if (it != loaded_.end() && it->second.expired()) loaded_.erase(it);
+}
+
+void TextureManager::setBudget(size_t bytes) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	budget_ = bytes;
+	evictFor(0);
+}
+
+size_t TextureManager::getResidentBytes() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return residentBytes_;
+}
+
+unsigned long long TextureManager::getTileLoads() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return tileLoads_;
+}
+
+unsigned long long TextureManager::getEvictions() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return evictions_;
+}
@@ -0,0 +1,68 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The TextureManager class
+*  Loads textures and keeps the tiles in memory within a byte
+*  budget.  Each file is opened once: loading the same path
+*  again returns the same Texture, which any number of objects
+*  and scenes may share.  When a new tile would exceed the
+*  budget, tiles not looked up recently are dropped (clock
+*  replacement) and decoded again if needed later.  A file that
+*  has been rewritten since it was loaded is loaded afresh.
+*  confine() limits loading to names inside one directory, for
+*  scenes from untrusted sources such as RenderServer clients.
+*
+*  Usage:
+*      auto textures = std::make_shared<TextureManager>(budget);
+*      obj->setTexture(textures->load("Mars.bmp"));
+-------------------------------------------------------------*/
+
+#ifndef H_TEXTURE_MANAGER
+#define H_TEXTURE_MANAGER
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Texture.h"
+
+class TextureManager : public std::enable_shared_from_this<TextureManager> {
+private:
+	friend class Texture;
+
+	struct Resident {
+		Texture* texture;
+		int tile;
+		size_t bytes;
+	};
+
+	size_t budget_;
+	bool confined_ = false;
+	std::string root_;                          //Directory confined names are read from
+	std::mutex mutex_;                          //Guards everything below
+	std::map<std::string, std::weak_ptr<Texture>> loaded_;
+	std::vector<Resident> resident_;
+	size_t clockHand_ = 0;
+	size_t residentBytes_ = 0;
+	unsigned long long tileLoads_ = 0;
+	unsigned long long evictions_ = 0;
+
+	std::shared_ptr<const Texture::Tile> pageIn(Texture& texture, int tile);
+	void evictFor(size_t bytes);
+	void forget(Texture* texture);
+
+public:
+	explicit TextureManager(size_t budget = size_t(512) << 20);
+
+	std::shared_ptr<Texture> load(const std::string& name);
+	void   confine(const std::string& dir);
+	bool   resolve(const std::string& name, std::string& path);
+	std::string identify(const std::string& name);
+	void   setBudget(size_t bytes);
+	size_t getResidentBytes();
+	unsigned long long getTileLoads();
+	unsigned long long getEvictions();
+};
+
+#endif //!H_TEXTURE_MANAGER
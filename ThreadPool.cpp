@@ -0,0 +1,52 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The ThreadPool class
+-------------------------------------------------------------*/
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads) {
+	if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+	for (int i = 0; i < threads; i++)
+		workers_.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+/**
+* Runs every task still queued, then joins the workers.
+*/
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	ready_.notify_all();
+	for (auto& w : workers_) w.join();
+}
+
+void ThreadPool::submit(int priority, std::function<void()> fn) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		queue_.push(Task{ priority, nextSeq_++, std::move(fn) });
+	}
+	ready_.notify_one();
+}
+
+int ThreadPool::size() {
+	return (int)workers_.size();
+}
+
+void ThreadPool::workerLoop() {
+	for (;;) {
+		Task task;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			ready_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+			if (queue_.empty()) return;   //Stopping and nothing left to do
+			task = queue_.top();
+			queue_.pop();
+		}
+		task.fn();
+	}
+}
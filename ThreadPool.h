@@ -0,0 +1,50 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The ThreadPool class
+*  A fixed set of worker threads serving one queue of tasks.
+*  Tasks with a higher priority run first; tasks of equal
+*  priority run in the order they were submitted.
+-------------------------------------------------------------*/
+
+#ifndef H_THREAD_POOL
+#define H_THREAD_POOL
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+private:
+	struct Task {
+		int priority;
+		unsigned long long seq;
+		std::function<void()> fn;
+		bool operator<(const Task& o) const {   //Lowest element pops last
+			return priority != o.priority ? priority < o.priority : seq > o.seq;
+		}
+	};
+
+	std::priority_queue<Task> queue_;
+	std::vector<std::thread> workers_;
+	std::mutex mutex_;
+	std::condition_variable ready_;
+	unsigned long long nextSeq_ = 0;
+	bool stop_ = false;
+
+	void workerLoop();
+
+public:
+	explicit ThreadPool(int threads = 0);   //0 means one per hardware thread
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void submit(int priority, std::function<void()> fn);
+	int  size();
+};
+
+#endif //!H_THREAD_POOL
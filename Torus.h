@@ -2,22 +2,21 @@
 #define H_TORUS
 
 #include <glm/glm.hpp>
-#include "SceneObject.h"
+#include "SDFObject.h"
 
-class Torus : public SceneObject {
+class Torus : public SDFObject {
 private:
     glm::vec3 center;
     float     Rmaj; 
     float     Rmin;
 
-    float distanceEstimator(const glm::vec3& p) const;
-
 public:
-    Torus() {}
     Torus(glm::vec3 c, float majorR, float minorR)
-      : center(c), Rmaj(majorR), Rmin(minorR) {}
+      : SDFObject(sdTorus(c, majorR, minorR),
+                  c - glm::vec3(majorR + minorR, majorR + minorR, minorR),
+                  c + glm::vec3(majorR + minorR, majorR + minorR, minorR)),
+        center(c), Rmaj(majorR), Rmin(minorR) {}
 
-    float       intersect(glm::vec3 p0, glm::vec3 dir) override;
     glm::vec3   normal   (glm::vec3 p)       override;
 };
 
@@ -0,0 +1,56 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Transform struct
+-------------------------------------------------------------*/
+
+#include "Transform.h"
+#include <cmath>
+
+Transform Transform::inverse() const {
+	Transform inv;
+	inv.linear = glm::inverse(linear);
+	inv.offset = -(inv.linear * offset);
+	return inv;
+}
+
+Transform Transform::operator*(const Transform& rhs) const {
+	Transform t;
+	t.linear = linear * rhs.linear;
+	t.offset = linear * rhs.offset + offset;
+	return t;
+}
+
+Transform Transform::translate(glm::vec3 v) {
+	Transform t;
+	t.offset = v;
+	return t;
+}
+
+Transform Transform::scale(glm::vec3 s) {
+	Transform t;
+	t.linear = glm::mat3(glm::vec3(s.x, 0, 0), glm::vec3(0, s.y, 0), glm::vec3(0, 0, s.z));
+	return t;
+}
+
+//The matrices below are written column by column (glm is column-major)
+Transform Transform::rotateX(float degrees) {
+	float c = cos(glm::radians(degrees)), s = sin(glm::radians(degrees));
+	Transform t;
+	t.linear = glm::mat3(glm::vec3(1, 0, 0), glm::vec3(0, c, s), glm::vec3(0, -s, c));
+	return t;
+}
+
+Transform Transform::rotateY(float degrees) {
+	float c = cos(glm::radians(degrees)), s = sin(glm::radians(degrees));
+	Transform t;
+	t.linear = glm::mat3(glm::vec3(c, 0, -s), glm::vec3(0, 1, 0), glm::vec3(s, 0, c));
+	return t;
+}
+
+Transform Transform::rotateZ(float degrees) {
+	float c = cos(glm::radians(degrees)), s = sin(glm::radians(degrees));
+	Transform t;
+	t.linear = glm::mat3(glm::vec3(c, s, 0), glm::vec3(-s, c, 0), glm::vec3(0, 0, 1));
+	return t;
+}
@@ -0,0 +1,31 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  The Transform struct
+*  An affine 3x4 transform: a 3x3 linear part followed by a
+*  translation.  Used by Instance to place shared geometry.
+-------------------------------------------------------------*/
+
+#ifndef H_TRANSFORM
+#define H_TRANSFORM
+
+#include <glm/glm.hpp>
+
+struct Transform {
+	glm::mat3 linear = glm::mat3(1.0f);
+	glm::vec3 offset = glm::vec3(0);
+
+	glm::vec3 applyPoint(glm::vec3 p) const { return linear * p + offset; }
+	glm::vec3 applyVector(glm::vec3 v) const { return linear * v; }
+
+	Transform inverse() const;
+	Transform operator*(const Transform& rhs) const;   //rhs is applied first
+
+	static Transform translate(glm::vec3 t);
+	static Transform scale(glm::vec3 s);
+	static Transform rotateX(float degrees);
+	static Transform rotateY(float degrees);
+	static Transform rotateZ(float degrees);
+};
+
+#endif //!H_TRANSFORM
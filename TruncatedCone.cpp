@@ -70,3 +70,71 @@ glm::vec3 TruncatedCone::normal(glm::vec3 p) {
                  lp.z);
     return glm::normalize(n);
 }
+
+// Within the slab between the caps the radius is never negative, so the cone is
+// the set where u^2 + v^2 - R(w)^2 <= 0: a quadratic in t, which is negative between
+// its roots when A > 0 and outside them when A < 0 (the line crosses the other nappe
+// of the double cone).  Clipped to the slab, one piece at most is left.
+bool TruncatedCone::intervals(glm::vec3 p0, glm::vec3 dir, SpanList& spans) {
+    glm::vec3 ro = p0 - center;
+    float halfH = height * 0.5f;
+    float tIn, tOut;
+    if (std::fabs(dir.y) <= EPS) {
+        if (std::fabs(ro.y) > halfH) return false;
+        tIn = -1.e+30f;
+        tOut = 1.e+30f;
+    }
+    else {
+        float ta = (-halfH - ro.y) / dir.y;
+        float tb = ( halfH - ro.y) / dir.y;
+        tIn  = std::min(ta, tb);
+        tOut = std::max(ta, tb);
+    }
+
+    float dr = (r2 - r1) / height;
+    float u = ro.x, v = ro.z, w = ro.y + halfH;
+    float R0 = r1 + dr * w;
+    float D  = dr * dir.y;
+    float A = dir.x*dir.x + dir.z*dir.z - D*D;
+    float B = 2.0f * (u*dir.x + v*dir.z - R0*D);
+    float C = u*u + v*v - R0*R0;
+
+    if (std::fabs(A) <= EPS) {
+        if (std::fabs(B) <= EPS) {
+            if (C > 0.0f) return false;
+        }
+        else if (B > 0.0f) tOut = std::min(tOut, -C / B);
+        else               tIn  = std::max(tIn,  -C / B);
+    }
+    else {
+        float disc = B*B - 4*A*C;
+        if (disc <= 0.0f) {
+            if (A > 0.0f) return false;   //Never inside; for A < 0 always inside
+        }
+        else {
+            float sq = std::sqrt(disc);
+            float t0 = (-B - sq) / (2*A);
+            float t1 = (-B + sq) / (2*A);
+            if (t0 > t1) std::swap(t0, t1);
+            if (A > 0.0f) {
+                tIn  = std::max(tIn, t0);
+                tOut = std::min(tOut, t1);
+            }
+            else if (tIn < t0) tOut = std::min(tOut, t0);
+            else               tIn  = std::max(tIn, t1);
+        }
+    }
+
+    if (tIn >= tOut) return false;
+    spans.clear();
+    spans.add(tIn, tOut);
+    return true;
+}
+
+bool TruncatedCone::getBounds(glm::vec3& lo, glm::vec3& hi) {
+    float r = std::max(r1, r2);
+    glm::vec3 ext(r, height * 0.5f, r);
+    lo = center - ext;
+    hi = center + ext;
+    return true;
+}
@@ -19,6 +19,11 @@ public:
     float intersect(glm::vec3 p0, glm::vec3 dir) override;
 
     glm::vec3 normal(glm::vec3 p) override;
+
+    bool getBounds(glm::vec3& lo, glm::vec3& hi) override;
+
+    bool intervals(glm::vec3 p0, glm::vec3 dir, SpanList& spans) override;
+    bool hasIntervals() override { return true; }
 };
 
 #endif
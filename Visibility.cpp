@@ -0,0 +1,52 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Primary visibility pass
+*  Objects are processed in scene order and a hit replaces the
+*  stored one only if it is strictly nearer, which is the same
+*  tie-breaking rule as Ray::closestPt.
+-------------------------------------------------------------*/
+
+#include "Visibility.h"
+#include "Ray.h"
+#include "Primitive.h"
+#include "Culling.h"
+
+/**
+* Fills 'vis' with the primary hits of cells [i0, i1) x [j0, j1) of a div x div
+* image with n x n samples per cell.
+*/
+void rasterizeVisibility(const Scene& scene, const Camera& cam, int div, int n,
+                         VisibilityBuffer& vis, int i0, int j0, int i1, int j1)
+{
+	vis.x0 = i0 * n;
+	vis.y0 = j0 * n;
+	vis.width = (i1 - i0) * n;
+	vis.height = (j1 - j0) * n;
+	vis.object.assign(vis.width * vis.height, -1);
+	vis.depth.assign(vis.width * vis.height, 1.e+6f);   //Same far limit as closestPt
+
+	for (int k = 0; k < (int)scene.objects.size(); k++) {
+		SceneObject* obj = scene.objects[k];
+		int s0 = vis.x0, s1 = vis.x0 + vis.width - 1;
+		int t0 = vis.y0, t1 = vis.y0 + vis.height - 1;
+		if (!screenFootprint(obj, cam, div * n, s0, s1, t0, t1)) continue;
+
+		//Dispatch on the object's type once, outside the sample loop
+		std::visit([&](auto* prim) {
+			for (int t = t0; t <= t1; t++) {
+				int j = t / n, sy = t % n;
+				for (int s = s0; s <= s1; s++) {
+					int i = s / n, sx = s % n;
+					Ray ray(cam.eye, cam.sampleDir(i, j, sx, sy, div, n));
+					float d = intersectStatic(prim, ray.p0, ray.dir);
+					int q = (t - vis.y0) * vis.width + s - vis.x0;
+					if (d > 0 && d < vis.depth[q]) {
+						vis.depth[q] = d;
+						vis.object[q] = k;
+					}
+				}
+			}
+		}, scene.primitives[k]);
+	}
+}
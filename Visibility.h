@@ -0,0 +1,35 @@
+/*----------------------------------------------------------
+* COSC363  Ray Tracer
+*
+*  Primary visibility pass
+*  Finds the first hit of every primary sample in object order,
+*  like a rasterizer: each object's bounding box is projected to
+*  the image, and only the samples inside that footprint are
+*  tested against the object, keeping the nearest hit in a depth
+*  buffer.  The result is exactly what Ray::closestPt would give
+*  for the same rays, at a fraction of the intersection tests.
+-------------------------------------------------------------*/
+
+#ifndef H_VISIBILITY
+#define H_VISIBILITY
+
+#include <vector>
+#include "Scene.h"
+#include "Camera.h"
+
+struct VisibilityBuffer {
+	int x0 = 0, y0 = 0;          //First sample covered (the buffer may hold one tile)
+	int width = 0;               //Samples per row (cells x AA grid)
+	int height = 0;
+	std::vector<int> object;     //Index of the nearest object, -1 if none
+	std::vector<float> depth;    //Ray parameter of the nearest hit
+
+	int index(int i, int j, int sx, int sy, int n) const {
+		return (j * n + sy - y0) * width + i * n + sx - x0;
+	}
+};
+
+void rasterizeVisibility(const Scene& scene, const Camera& cam, int div, int n,
+                         VisibilityBuffer& vis, int i0, int j0, int i1, int j1);
+
+#endif //!H_VISIBILITY